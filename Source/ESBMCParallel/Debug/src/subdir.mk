@@ -4,16 +4,52 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
+../src/Benchmark.cpp \
+../src/CgroupManager.cpp \
+../src/ChildSupervisor.cpp \
+../src/CpuTopology.cpp \
 ../src/ESBMCParallel.cpp \
-../src/ParallelController.cpp 
+../src/HedgeTracker.cpp \
+../src/LoadGovernor.cpp \
+../src/ParallelController.cpp \
+../src/RetryLadder.cpp \
+../src/RunHistory.cpp \
+../src/RuntimeModel.cpp \
+../src/StepCache.cpp \
+../src/StepDispenser.cpp \
+../src/VerdictScanner.cpp 
 
 OBJS += \
+./src/Benchmark.o \
+./src/CgroupManager.o \
+./src/ChildSupervisor.o \
+./src/CpuTopology.o \
 ./src/ESBMCParallel.o \
-./src/ParallelController.o 
+./src/HedgeTracker.o \
+./src/LoadGovernor.o \
+./src/ParallelController.o \
+./src/RetryLadder.o \
+./src/RunHistory.o \
+./src/RuntimeModel.o \
+./src/StepCache.o \
+./src/StepDispenser.o \
+./src/VerdictScanner.o 
 
 CPP_DEPS += \
+./src/Benchmark.d \
+./src/CgroupManager.d \
+./src/ChildSupervisor.d \
+./src/CpuTopology.d \
 ./src/ESBMCParallel.d \
-./src/ParallelController.d 
+./src/HedgeTracker.d \
+./src/LoadGovernor.d \
+./src/ParallelController.d \
+./src/RetryLadder.d \
+./src/RunHistory.d \
+./src/RuntimeModel.d \
+./src/StepCache.d \
+./src/StepDispenser.d \
+./src/VerdictScanner.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -471,9 +471,14 @@ int E [MAXe] [MAXn] = {{0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.0000
 	  fobj += x[i] * h[i];
   }
 
+#ifdef MONOTONE_QUERY
+  //fails iff some partition has fobj <= valordeh, so the answer is monotone in valordeh
+  assert(fobj > valordeh);
+#else
   __ESBMC_assume(fobj <= valordeh);
 
   assert(fobj < valordeh);
+#endif
   return 0;
 }
 
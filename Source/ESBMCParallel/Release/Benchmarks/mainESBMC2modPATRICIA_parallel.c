@@ -96,9 +96,14 @@ int E [MAXe] [MAXn] = {{-1.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
     fobj += x[i]*h[i];
   }
 
+#ifdef MONOTONE_QUERY
+  //fails iff some partition has fobj <= valordeh, so the answer is monotone in valordeh
+  assert(fobj > valordeh);
+#else
 __ESBMC_assume (fobj <= valordeh);
 
   assert (fobj < valordeh);
+#endif
   return 0;
 }
 
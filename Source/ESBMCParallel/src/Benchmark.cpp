@@ -0,0 +1,310 @@
+/*
+ * Benchmark.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <ctype.h>
+#include <fstream>
+#include <sstream>
+#include <stdint.h>
+
+static bool is_identifier(char c) {
+	return isalnum(c) || c == '_';
+}
+
+//C semantics: missing initialisers are zero, excess ones are dropped.
+static void resize_row(std::vector<int>& row, int size) {
+	row.resize(size, 0);
+}
+
+Benchmark::Benchmark() {
+	this->loaded = false;
+	this->nodes = 0;
+	this->edges = 0;
+	this->costBound = INT_MAX;
+	this->queryForm = QUERY_EXACT;
+	this->monotoneSwitch = false;
+}
+
+Benchmark::~Benchmark() {
+
+}
+
+bool Benchmark::load(std::string filename) {
+	std::ifstream file(filename);
+	if (!file)
+		return false;
+
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	source = buffer.str();
+
+	detectQueryForm();
+
+	std::vector<std::vector<int>> rows;
+
+	if (!parseDefine("MAXn", nodes) || !parseDefine("MAXe", edges))
+		return false;
+
+	if (!parseArray("h", rows))
+		return false;
+	h = rows[0];
+	resize_row(h, nodes);
+
+	if (!parseArray("s", rows))
+		return false;
+	s = rows[0];
+	resize_row(s, nodes);
+
+	if (!parseArray("c", rows))
+		return false;
+	c = rows[0];
+	resize_row(c, edges);
+
+	if (!parseArray("E", rows))
+		return false;
+	E = rows;
+	E.resize(edges);
+	for (auto &row : E)
+		resize_row(row, nodes);
+
+	parseCostBound();
+
+	source.clear();
+	loaded = true;
+
+	return true;
+}
+
+bool Benchmark::isLoaded() {
+	return loaded;
+}
+
+int Benchmark::getNodes() {
+	return nodes;
+}
+
+int Benchmark::getEdges() {
+	return edges;
+}
+
+QueryForm Benchmark::getQueryForm() {
+	return queryForm;
+}
+
+//true when the model offers the <= form behind -DMONOTONE_QUERY.
+bool Benchmark::hasMonotoneSwitch() {
+	return monotoneSwitch;
+}
+
+Evaluation Benchmark::evaluate(std::vector<int>& x) {
+	Evaluation evaluation { false, 0, 0, 0 };
+
+	if (!loaded || (int) x.size() != nodes)
+		return evaluation;
+
+	for (int i = 0; i < nodes; i++) {
+		if (x[i] != 0 && x[i] != 1)
+			return evaluation;
+
+		evaluation.softcost += s[i] * (1 - x[i]);
+		evaluation.fobj += x[i] * h[i];
+	}
+
+	for (int i = 0; i < edges; i++) {
+		int aux = 0;
+		for (int j = 0; j < nodes; j++)
+			aux += E[i][j] * x[j];
+
+		evaluation.comcost += c[i] * std::abs(aux);
+	}
+
+	evaluation.valid = evaluation.softcost + evaluation.comcost <= costBound;
+
+	return evaluation;
+}
+
+//Subset sums of h[] over a bitset: bit k is set iff some x[] gives fobj == k.
+//Adding item w is bits |= bits << w, done a 64-bit word at a time from the top
+//so that the loop stays branch-free and vectorises.
+bool Benchmark::getReachableObjectives(int hmin, int hmax, std::vector<int>& reachable) {
+	reachable.clear();
+
+	if (!loaded || hmax < 0)
+		return false;
+
+	for (int i = 0; i < nodes; i++)
+		if (h[i] < 0)
+			return false;
+
+	std::vector<uint64_t> bits((hmax >> 6) + 1, 0);
+	int words = bits.size();
+	bits[0] = 1;
+
+	for (int i = 0; i < nodes; i++) {
+		int w = h[i];
+		if (w == 0 || w > hmax)
+			continue;
+
+		int shift = w >> 6;
+		int offset = w & 63;
+
+		if (offset == 0) {
+			for (int j = words - 1; j >= shift; j--)
+				bits[j] |= bits[j - shift];
+		} else {
+			for (int j = words - 1; j > shift; j--)
+				bits[j] |= (bits[j - shift] << offset) | (bits[j - shift - 1] >> (64 - offset));
+			bits[shift] |= bits[0] << offset;
+		}
+	}
+
+	for (int k = std::max(hmin, 0); k <= hmax; k++)
+		if (bits[k >> 6] >> (k & 63) & 1)
+			reachable.push_back(k);
+
+	return true;
+}
+
+bool Benchmark::parseDefine(std::string name, int& value) {
+	size_t pos = source.find("#define " + name);
+	if (pos == std::string::npos)
+		return false;
+
+	value = std::atoi(source.c_str() + pos + 8 + name.size());
+
+	return value > 0;
+}
+
+bool Benchmark::parseArray(std::string name, std::vector<std::vector<int>>& rows) {
+	size_t pos = 0;
+
+	//look for "int <name> [" so that e.g. the h in "fobj += x[i] * h[i]" is skipped.
+	while ((pos = source.find(name, pos)) != std::string::npos) {
+		size_t end = pos + name.size();
+		size_t before = pos;
+
+		while (before > 0 && isspace(source[before - 1]))
+			before--;
+
+		bool declared = before >= 3 && source.compare(before - 3, 3, "int") == 0
+				&& (before == 3 || !is_identifier(source[before - 4]))
+				&& before < pos && !is_identifier(source[end]);
+
+		while (end < source.size() && isspace(source[end]))
+			end++;
+
+		if (declared && end < source.size() && source[end] == '[')
+			break;
+
+		pos += name.size();
+	}
+
+	if (pos == std::string::npos)
+		return false;
+
+	pos = source.find('{', pos);
+	if (pos == std::string::npos)
+		return false;
+
+	rows.clear();
+	int depth = 0;
+
+	while (pos < source.size()) {
+		char ch = source[pos];
+
+		if (ch == '{') {
+			depth++;
+			if (depth == 2)
+				rows.push_back(std::vector<int>());
+			pos++;
+		} else if (ch == '}') {
+			depth--;
+			pos++;
+			if (depth == 0)
+				break;
+		} else if (isdigit(ch) || ch == '-' || ch == '+' || ch == '.') {
+			char* next;
+			double value = strtod(source.c_str() + pos, &next);
+
+			if (next == source.c_str() + pos) {
+				pos++;
+				continue;
+			}
+
+			if (rows.empty())
+				rows.push_back(std::vector<int>());
+
+			rows.back().push_back((int) value);
+			pos = next - source.c_str();
+		} else {
+			pos++;
+		}
+	}
+
+	return !rows.empty();
+}
+
+bool Benchmark::parseCostBound() {
+	size_t pos = source.find("(softcost+comcost)");
+	if (pos == std::string::npos)
+		return false;
+
+	pos = source.find("<=", pos);
+	if (pos == std::string::npos)
+		return false;
+
+	pos += 2;
+	while (pos < source.size() && isspace(source[pos]))
+		pos++;
+
+	if (pos < source.size() && isdigit(source[pos])) {
+		costBound = (int) strtod(source.c_str() + pos, NULL);
+		return true;
+	}
+
+	//a named bound such as S0: use its initialiser.
+	size_t end = pos;
+	while (end < source.size() && is_identifier(source[end]))
+		end++;
+
+	std::string bound = source.substr(pos, end - pos);
+	pos = 0;
+
+	while (!bound.empty() && (pos = source.find(bound, pos)) != std::string::npos) {
+		size_t value = pos + bound.size();
+		while (value < source.size() && isspace(source[value]))
+			value++;
+
+		if ((pos == 0 || !is_identifier(source[pos - 1])) && value < source.size() && source[value] == '='
+				&& source[value + 1] != '=') {
+			costBound = (int) strtod(source.c_str() + value + 1, NULL);
+			return true;
+		}
+
+		pos += bound.size();
+	}
+
+	return false;
+}
+
+void Benchmark::detectQueryForm() {
+	std::string compact;
+	for (char ch : source)
+		if (!isspace(ch))
+			compact += ch;
+
+	monotoneSwitch = compact.find("#ifdefMONOTONE_QUERY") != std::string::npos;
+
+	if (compact.find("assert(fobj>valordeh)") != std::string::npos
+			&& compact.find("assume(fobj<=valordeh)") == std::string::npos)
+		queryForm = QUERY_MONOTONE;
+	else
+		queryForm = QUERY_EXACT;
+}
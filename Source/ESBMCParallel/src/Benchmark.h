@@ -0,0 +1,64 @@
+/*
+ * Benchmark.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <string>
+#include <vector>
+
+//EXACT: fails iff a partition has fobj == valordeh (assume <=, assert <).
+//MONOTONE: fails iff a partition has fobj <= valordeh (assert >), so a
+//feasible bound stays feasible for every larger valordeh.
+enum QueryForm { QUERY_EXACT, QUERY_MONOTONE };
+
+struct Evaluation {
+	bool valid;
+	int fobj;
+	int softcost;
+	int comcost;
+};
+
+//Instance data (h, s, c, E and the cost bound) read back from a partitioning
+//benchmark, so a counterexample's x[] can be re-evaluated outside ESBMC.
+class Benchmark {
+public:
+	Benchmark();
+	virtual ~Benchmark();
+
+	bool load(std::string filename);
+	bool isLoaded();
+
+	int getNodes();
+	int getEdges();
+
+	QueryForm getQueryForm();
+	bool hasMonotoneSwitch();
+
+	Evaluation evaluate(std::vector<int>& x);
+
+	//sorted values in [hmin, hmax] that sum(x[i] * h[i]) can take.
+	bool getReachableObjectives(int hmin, int hmax, std::vector<int>& reachable);
+private:
+	bool parseDefine(std::string name, int& value);
+	bool parseArray(std::string name, std::vector<std::vector<int>>& rows);
+	bool parseCostBound();
+	void detectQueryForm();
+
+	std::string source;
+	bool loaded;
+	int nodes;
+	int edges;
+	int costBound;
+	QueryForm queryForm;
+	bool monotoneSwitch;
+	std::vector<int> h;
+	std::vector<int> s;
+	std::vector<int> c;
+	std::vector<std::vector<int>> E;
+};
+
+#endif /* BENCHMARK_H_ */
@@ -0,0 +1,208 @@
+/*
+ * CgroupManager.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "CgroupManager.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <sstream>
+
+static bool write_file(std::string path, std::string value) {
+	int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	bool written = write(fd, value.c_str(), value.size()) == (ssize_t) value.size();
+	::close(fd);
+
+	return written;
+}
+
+static std::string read_file(std::string path) {
+	std::ifstream file(path);
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+
+	return buffer.str();
+}
+
+static bool has_word(std::string text, std::string word) {
+	std::istringstream words(text);
+	std::string current;
+
+	while (words >> current)
+		if (current == word)
+			return true;
+
+	return false;
+}
+
+CgroupManager::CgroupManager() {
+	this->opened = false;
+	this->leaves = 0;
+}
+
+CgroupManager::~CgroupManager() {
+	close();
+}
+
+bool CgroupManager::open(std::string path) {
+	std::ifstream mounts("/proc/self/mounts");
+	std::string device, point, type, rest;
+
+	while (mounts >> device >> point >> type && std::getline(mounts, rest))
+		if (type == "cgroup2") {
+			mount = point;
+			break;
+		}
+
+	if (mount.empty()) {
+		error = "no cgroup v2 hierarchy";
+		return false;
+	}
+
+	if (path.empty()) {
+		std::ifstream self("/proc/self/cgroup");
+		std::string line;
+
+		while (std::getline(self, line))
+			if (line.compare(0, 3, "0::") == 0)
+				base = mount + line.substr(3);
+
+		if (!base.empty() && base[base.size() - 1] == '/')
+			base.erase(base.size() - 1);
+	} else {
+		base = path;
+	}
+
+	//a cgroup that holds processes cannot hand controllers down (unless it is
+	//the root), so an auto-detected cgroup usually has to be delegated instead.
+	if (!has_word(read_file(base + "/cgroup.controllers"), "memory")
+			|| !has_word(read_file(base + "/cgroup.controllers"), "cpu")) {
+		error = "no memory and cpu controllers in " + base;
+		return false;
+	}
+
+	if (!write_file(base + "/cgroup.subtree_control", "+memory +cpu")) {
+		error = "cannot enable memory and cpu below " + base + " (" + strerror(errno) + ")";
+		return false;
+	}
+
+	group = base + "/esbmc-parallel-" + std::to_string(getpid());
+
+	if (mkdir(group.c_str(), 0755) != 0 && errno != EEXIST) {
+		error = "cannot create " + group + " (" + strerror(errno) + ")";
+		return false;
+	}
+
+	if (!write_file(group + "/cgroup.subtree_control", "+memory +cpu")) {
+		error = "cannot enable memory and cpu in " + group + " (" + strerror(errno) + ")";
+		rmdir(group.c_str());
+		return false;
+	}
+
+	opened = true;
+
+	return true;
+}
+
+void CgroupManager::close() {
+	if (!opened)
+		return;
+
+	rmdir(group.c_str());
+	opened = false;
+}
+
+bool CgroupManager::isOpen() {
+	return opened;
+}
+
+std::string CgroupManager::getPath() {
+	return group;
+}
+
+std::string CgroupManager::getError() {
+	return error;
+}
+
+//The leaf exists before its child: with clone3 and CLONE_INTO_CGROUP the child
+//starts inside it, limits and all. Without clone3 it starts in our own group
+//and join() moves it once posix_spawn returns, so its exec and first
+//allocations are not charged to the leaf.
+std::string CgroupManager::create(long memoryMaxKb, int cpuWeight) {
+	if (!opened)
+		return "";
+
+	std::string leaf = group + "/step-" + std::to_string(++leaves);
+
+	if (mkdir(leaf.c_str(), 0755) != 0)
+		return "";
+
+	write_file(leaf + "/memory.max", memoryMaxKb > 0 ? std::to_string(memoryMaxKb * 1024) : "max");
+	//swapping a multi-GB step only delays the OOM kill it is heading for.
+	write_file(leaf + "/memory.swap.max", "0");
+
+	if (cpuWeight > 0)
+		write_file(leaf + "/cpu.weight", std::to_string(cpuWeight));
+
+	return leaf;
+}
+
+bool CgroupManager::join(std::string leaf, pid_t pid) {
+	return write_file(leaf + "/cgroup.procs", std::to_string(pid));
+}
+
+void CgroupManager::remove(std::string leaf) {
+	rmdir(leaf.c_str());
+}
+
+long CgroupManager::getCurrentKb(std::string leaf) {
+	return atoll(read_file(leaf + "/memory.current").c_str()) / 1024;
+}
+
+void CgroupManager::release(std::string leaf, long& peakKb, bool& oomKilled) {
+	//memory.peak needs Linux 5.19.
+	std::string peak = read_file(leaf + "/memory.peak");
+	peakKb = peak.empty() ? 0 : atoll(peak.c_str()) / 1024;
+
+	std::istringstream events(read_file(leaf + "/memory.events"));
+	std::string name;
+	long count;
+
+	oomKilled = false;
+	while (events >> name >> count)
+		if (name == "oom_kill" && count > 0)
+			oomKilled = true;
+
+	rmdir(leaf.c_str());
+}
+
+bool CgroupManager::freeze(std::string leaf, bool frozen) {
+	return write_file(leaf + "/cgroup.freeze", frozen ? "1" : "0");
+}
+
+long CgroupManager::getLimitKb() {
+	long limit = 0;
+
+	for (std::string path = base; path.size() > mount.size(); path = path.substr(0, path.rfind('/'))) {
+		std::string value = read_file(path + "/memory.max");
+
+		if (value.empty() || value.compare(0, 3, "max") == 0)
+			continue;
+
+		long kb = atoll(value.c_str()) / 1024;
+		if (limit == 0 || kb < limit)
+			limit = kb;
+	}
+
+	return limit;
+}
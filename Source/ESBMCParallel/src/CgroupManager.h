@@ -0,0 +1,51 @@
+/*
+ * CgroupManager.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef CGROUPMANAGER_H_
+#define CGROUPMANAGER_H_
+
+#include <sys/types.h>
+#include <string>
+
+//One cgroup v2 group per run, holding a leaf per ESBMC child with its own
+//memory.max and cpu.weight. A runaway step is then OOM-killed on its own,
+//and memory.events says so instead of leaving a bare SIGKILL to guess from.
+class CgroupManager {
+public:
+	CgroupManager();
+	virtual ~CgroupManager();
+
+	//path empty: below this process's own cgroup. false when the memory and
+	//cpu controllers cannot be enabled there; getError() says why.
+	bool open(std::string path);
+	void close();
+	bool isOpen();
+	std::string getPath();
+	std::string getError();
+
+	//a new leaf with its limits set, or "" on failure. 0 is no limit. A child
+	//is best started inside it (clone3 with CLONE_INTO_CGROUP); join() moves
+	//one that is already running, after its startup has gone unaccounted.
+	std::string create(long memoryMaxKb, int cpuWeight);
+	bool join(std::string leaf, pid_t pid);
+	void remove(std::string leaf);
+	long getCurrentKb(std::string leaf);
+	//peak usage and whether the OOM killer fired; the leaf is removed.
+	void release(std::string leaf, long& peakKb, bool& oomKilled);
+	//cgroup.freeze: stops or resumes every process in the leaf.
+	bool freeze(std::string leaf, bool frozen);
+	//the tightest memory.max above the group, 0 when there is none.
+	long getLimitKb();
+private:
+	bool opened;
+	std::string mount;
+	std::string base;
+	std::string group;
+	std::string error;
+	int leaves;
+};
+
+#endif /* CGROUPMANAGER_H_ */
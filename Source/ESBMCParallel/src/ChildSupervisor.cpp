@@ -0,0 +1,902 @@
+/*
+ * ChildSupervisor.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "ChildSupervisor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sstream>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <linux/sched.h>
+
+#define READ 0
+#define WRITE 1
+
+//a suspension has to buy at least this much more value, or steps thrash.
+#define PREEMPT_MARGIN 1.5
+
+static int pidfd_open(pid_t pid) {
+#ifdef SYS_pidfd_open
+	return syscall(SYS_pidfd_open, pid, 0);
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+//The PATH lookup execvp would do, done before cloning: the child may only
+//make async-signal-safe calls, and execve is one while execvp is not.
+static std::string resolve_executable(std::string file) {
+	if (file.find('/') != std::string::npos)
+		return file;
+
+	const char* path = getenv("PATH");
+	std::istringstream directories(path != NULL ? path : "/usr/local/bin:/bin:/usr/bin");
+	std::string directory;
+
+	while (std::getline(directories, directory, ':')) {
+		std::string candidate = (directory.empty() ? "." : directory) + "/" + file;
+		if (access(candidate.c_str(), X_OK) == 0)
+			return candidate;
+	}
+
+	return "";
+}
+
+//clone3 with CLONE_INTO_CGROUP (Linux 5.7): the child is in its leaf before it
+//runs a single instruction of ESBMC. -1 with errno set when the kernel or the
+//delegation does not allow it. Between clone and exec the child is a copy of a
+//multi-threaded process, so it only makes async-signal-safe calls.
+static pid_t spawn_into_cgroup(char** argv, int outFd, std::string leaf) {
+#if defined(SYS_clone3) && defined(CLONE_INTO_CGROUP)
+	std::string file = resolve_executable(argv[0]);
+	if (file.empty()) {
+		errno = ENOENT;
+		return -1;
+	}
+
+	int cgroupFd = open(leaf.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (cgroupFd < 0)
+		return -1;
+
+	clone_args args;
+	memset(&args, 0, sizeof(args));
+	args.flags = CLONE_INTO_CGROUP;
+	args.exit_signal = SIGCHLD;
+	args.cgroup = cgroupFd;
+
+	pid_t pid = syscall(SYS_clone3, &args, sizeof(args));
+
+	if (pid == 0) {
+		int null = open("/dev/null", O_RDONLY | O_CLOEXEC);
+		if (null < 0 || dup2(null, STDIN_FILENO) < 0 || dup2(outFd, STDOUT_FILENO) < 0 || setpgid(0, 0) != 0)
+			_exit(127);
+
+		execve(file.c_str(), argv, environ);
+		_exit(127);
+	}
+
+	int error = errno;
+	close(cgroupFd);
+
+	//both sides set the group, as posix_spawn's SETPGROUP does before exec, so
+	//that kill(-pid) cannot run ahead of the child. EACCES: it already exec'd.
+	if (pid > 0)
+		setpgid(pid, pid);
+
+	errno = error;
+
+	return pid;
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+ChildSupervisor::ChildSupervisor() {
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	running = false;
+	outputCapacity = 64 * 1024;
+	traceOnly = false;
+	killOnVerdict = false;
+	witnessSize = 0;
+	abortedCpuSeconds = 0;
+	spawnMilliseconds = 0;
+	spawnCount = 0;
+	waiting = 0;
+	pendingKb = 0;
+	cgroups = NULL;
+	memoryBudget = 0;
+	topology = NULL;
+	runningLimit = 0;
+	slots = 0;
+	suspensions = 0;
+
+	epoll_event event;
+	event.events = EPOLLIN;
+	event.data.fd = eventFd;
+	epoll_ctl(epollFd, EPOLL_CTL_ADD, eventFd, &event);
+}
+
+ChildSupervisor::~ChildSupervisor() {
+	stop();
+
+	close(eventFd);
+	close(epollFd);
+}
+
+void ChildSupervisor::start() {
+	if (running)
+		return;
+
+	running = true;
+	thread = std::thread(&ChildSupervisor::loop, this);
+}
+
+void ChildSupervisor::stop() {
+	if (!running)
+		return;
+
+	running = false;
+	notify();
+	thread.join();
+}
+
+void ChildSupervisor::notify() {
+	uint64_t one = 1;
+	if (write(eventFd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+		perror("eventfd");
+}
+
+void ChildSupervisor::setOutputPolicy(size_t capacity, bool traceOnly, bool killOnVerdict) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	this->outputCapacity = capacity;
+	this->traceOnly = traceOnly;
+	this->killOnVerdict = killOnVerdict;
+}
+
+void ChildSupervisor::setWitness(std::string variable, int size) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	this->witnessVariable = variable;
+	this->witnessSize = size;
+}
+
+void ChildSupervisor::setMemoryPolicy(CgroupManager* cgroups, long memoryKb) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	this->cgroups = cgroups;
+	this->memoryBudget = memoryKb;
+}
+
+void ChildSupervisor::setPlacement(CpuTopology* topology) {
+	std::lock_guard<std::mutex> lock(mutex);
+	this->topology = topology;
+}
+
+void ChildSupervisor::setRunningLimit(int limit) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->runningLimit = limit;
+		finished.notify_all();
+	}
+
+	//a reactor blocked in poll() re-checks admission when it wakes up.
+	notify();
+}
+
+int ChildSupervisor::getRunning() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	int running = 0;
+	for (auto &c : children)
+		if (!c.second->done)
+			running++;
+
+	return running;
+}
+
+void ChildSupervisor::setPreemption(int slots, std::function<double(int)> value) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	this->slots = slots;
+	this->value = value;
+}
+
+int ChildSupervisor::getSuspensions() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return suspensions;
+}
+
+double ChildSupervisor::getAbortedCpuSeconds() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return abortedCpuSeconds;
+}
+
+double ChildSupervisor::getSpawnMilliseconds() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return spawnMilliseconds;
+}
+
+int ChildSupervisor::getSpawnCount() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return spawnCount;
+}
+
+//A step with a maxRunning limit waits for the others to drain; while it waits,
+//steps without one are held back so that it is not starved.
+ChildResult ChildSupervisor::execute(int step, std::vector<std::string> arguments, std::function<bool()> isNeeded,
+		StepLimits limits) {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		if (limits.maxRunning > 0)
+			waiting++;
+
+		waitingSteps.insert(step);
+
+		finished.wait(lock, [this, &isNeeded, limits, step] {
+			if (!isNeeded())
+				return true;
+
+			if (!isAdmitted(limits) || (limits.maxRunning == 0 && waiting > 0))
+				return false;
+
+			return hasSlot(step);
+		});
+
+		waitingSteps.erase(waitingSteps.find(step));
+
+		if (limits.maxRunning > 0) {
+			waiting--;
+			finished.notify_all();
+		}
+
+		if (!isNeeded())
+			return ChildResult { step, VERDICT_NONE, "", std::vector<int>(), 0, true, 0, 0, 0, false, false, false };
+
+		pending.insert(limits.maxRunning);
+		pendingKb += limits.memoryKb;
+	}
+
+	Child* child = spawn(step, arguments, isNeeded, limits, false);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	pending.erase(pending.find(limits.maxRunning));
+	pendingKb -= limits.memoryKb;
+
+	if (child == NULL) {
+		finished.notify_all();
+		return ChildResult { step, VERDICT_ERROR, "", std::vector<int>(), -1, false, 0, 0, 0, false, false, false };
+	}
+
+	finished.wait(lock, [child] { return child->done; });
+
+	ChildResult result = child->result;
+	children.erase(child->pid);
+	delete child;
+
+	finished.notify_all();
+
+	return result;
+}
+
+pid_t ChildSupervisor::launch(int step, std::vector<std::string> arguments, std::function<bool()> isNeeded,
+		StepLimits limits) {
+	Child* child = spawn(step, arguments, isNeeded, limits, true);
+	if (child == NULL)
+		return -1;
+
+	return child->pid;
+}
+
+bool ChildSupervisor::admits(StepLimits limits) {
+	std::lock_guard<std::mutex> lock(mutex);
+	return isAdmitted(limits);
+}
+
+bool ChildSupervisor::isAdmitted(StepLimits limits) {
+	int running = 0;
+	int limit = limits.maxRunning;
+
+	for (auto &c : children) {
+		if (c.second->done || c.second->suspended)
+			continue;
+
+		running++;
+		if (c.second->limits.maxRunning > 0 && (limit == 0 || c.second->limits.maxRunning < limit))
+			limit = c.second->limits.maxRunning;
+	}
+
+	for (int maxRunning : pending) {
+		running++;
+		if (maxRunning > 0 && (limit == 0 || maxRunning < limit))
+			limit = maxRunning;
+	}
+
+	if (limit > 0 && running >= limit)
+		return false;
+
+	if (runningLimit > 0 && running >= runningLimit)
+		return false;
+
+	//with no prediction yet, a new step is taken to grow as large as the largest running one.
+	if (memoryBudget > 0 && running > 0) {
+		long largest = 0;
+		long used = usedMemoryKb(largest) + pendingKb;
+		long need = limits.memoryKb > 0 ? limits.memoryKb : largest;
+
+		if (used + need > memoryBudget)
+			return false;
+	}
+
+	return true;
+}
+
+//Each running child holds the larger of its live and its predicted usage.
+long ChildSupervisor::usedMemoryKb(long& largestKb) {
+	long used = 0;
+
+	for (auto &c : children) {
+		Child* child = c.second;
+		if (child->done)
+			continue;
+
+		long held = std::max(liveKb(child), child->limits.memoryKb);
+		used += held;
+		largestKb = std::max(largestKb, held);
+	}
+
+	return used;
+}
+
+long ChildSupervisor::liveKb(Child* child) {
+	if (!child->cgroup.empty())
+		return cgroups->getCurrentKb(child->cgroup);
+
+	//no cgroup: the resident set of the child itself.
+	char path[64];
+	snprintf(path, sizeof(path), "/proc/%d/statm", child->pid);
+
+	FILE* statm = fopen(path, "r");
+	if (statm == NULL)
+		return 0;
+
+	long size = 0, resident = 0;
+	if (fscanf(statm, "%ld %ld", &size, &resident) != 2)
+		resident = 0;
+	fclose(statm);
+
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+void ChildSupervisor::poll(int timeout) {
+	epoll_event events[64];
+
+	int n = epoll_wait(epollFd, events, 64, nextTimeout(timeout));
+
+	if (n < 0) {
+		if (errno != EINTR)
+			perror("epoll_wait");
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (int i = 0; i < n; i++) {
+		int fd = events[i].data.fd;
+
+		if (fd == eventFd) {
+			uint64_t count;
+			while (read(eventFd, &count, sizeof(count)) > 0)
+				;
+
+			checkNeeded();
+			continue;
+		}
+
+		//the fd may have been closed and reused since epoll_wait returned;
+		//both handlers are non-blocking, so a stale event is harmless.
+		auto it = fds.find(fd);
+		if (it == fds.end())
+			continue;
+
+		Child* child = it->second;
+		if (fd == child->outFd)
+			handleOutput(child);
+		else
+			handleExit(child);
+	}
+
+	checkTimeouts();
+	rebalance();
+}
+
+bool ChildSupervisor::nextCompletion(ChildResult& result) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (completions.empty())
+		return false;
+
+	result = completions.front();
+	completions.pop_front();
+
+	return true;
+}
+
+ChildSupervisor::Child* ChildSupervisor::spawn(int step, std::vector<std::string> arguments, std::function<bool()> isNeeded,
+		StepLimits limits, bool queued) {
+	int p_stdout[2];
+
+	if (pipe2(p_stdout, O_CLOEXEC) != 0)
+		return NULL;
+
+	std::vector<char*> argv;
+	for (auto &a : arguments)
+		argv.push_back(const_cast<char*>(a.c_str()));
+	argv.push_back(NULL);
+
+	//without a leaf, posix_spawn uses vfork semantics, so the multi-threaded parent is never
+	//copied and no shell is started; the child leads its own process group.
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+	posix_spawn_file_actions_adddup2(&actions, p_stdout[WRITE], STDOUT_FILENO);
+
+	posix_spawnattr_t attributes;
+	posix_spawnattr_init(&attributes);
+	posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+	posix_spawnattr_setpgroup(&attributes, 0);
+
+	//the leaf exists before the child does, so that memory.max, cpu.weight and
+	//memory.peak cover ESBMC's startup too. memory.max: whatever the budget
+	//does not already owe to the other children.
+	std::string leaf;
+	if (cgroups != NULL && cgroups->isOpen()) {
+		long memoryMax = 0;
+
+		if (memoryBudget > 0) {
+			std::lock_guard<std::mutex> lock(mutex);
+			long largest = 0;
+
+			memoryMax = std::max(limits.memoryKb, memoryBudget - usedMemoryKb(largest));
+			if (memoryMax <= 0)
+				memoryMax = memoryBudget;
+		}
+
+		leaf = cgroups->create(memoryMax, limits.cpuWeight);
+	}
+
+	//the child inherits this thread's CPU and memory policy from its first instruction.
+	std::vector<int> cpus;
+	if (topology != NULL)
+		cpus = topology->acquire(std::max(1, limits.cpus));
+	if (!cpus.empty())
+		topology->apply(cpus);
+
+	timespec before, after;
+	clock_gettime(CLOCK_MONOTONIC, &before);
+
+	//without clone3 into the leaf, the child is moved there once it runs.
+	pid_t pid = leaf.empty() ? -1 : spawn_into_cgroup(argv.data(), p_stdout[WRITE], leaf);
+	bool placed = pid > 0;
+	int error = 0;
+
+	if (!placed)
+		error = posix_spawnp(&pid, argv[0], &actions, &attributes, argv.data(), environ);
+
+	clock_gettime(CLOCK_MONOTONIC, &after);
+
+	if (!cpus.empty())
+		topology->restore();
+
+	posix_spawnattr_destroy(&attributes);
+	posix_spawn_file_actions_destroy(&actions);
+	close(p_stdout[WRITE]);
+
+	if (error != 0) {
+		errno = error;
+		perror(argv[0]);
+		close(p_stdout[READ]);
+		if (!cpus.empty())
+			topology->release(cpus);
+		if (!leaf.empty())
+			cgroups->remove(leaf);
+		return NULL;
+	}
+
+	if (!leaf.empty() && !placed && !cgroups->join(leaf, pid)) {
+		cgroups->remove(leaf);
+		leaf = "";
+	}
+
+	fcntl(p_stdout[READ], F_SETFL, fcntl(p_stdout[READ], F_GETFL, 0) | O_NONBLOCK);
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	Child* child = new Child(outputCapacity, traceOnly);
+	if (witnessSize > 0)
+		child->scanner.watch(witnessVariable, witnessSize);
+
+	child->pid = pid;
+	child->step = step;
+	child->outFd = p_stdout[READ];
+	child->pidFd = pidfd_open(pid);
+	child->outClosed = false;
+	child->exited = false;
+	child->done = false;
+	child->queued = queued;
+	child->started = after;
+	child->limits = limits;
+	child->cpus = cpus;
+	child->suspended = false;
+	child->frozen = false;
+	child->pausedSeconds = 0;
+	child->termSent = false;
+	child->killSent = false;
+	child->isNeeded = isNeeded;
+
+	child->cgroup = leaf;
+
+	child->result = ChildResult { step, VERDICT_NONE, "", std::vector<int>(), 0, false, 0, 0, 0, false, false, false };
+
+	spawnMilliseconds += (after.tv_sec - before.tv_sec) * 1e3 + (after.tv_nsec - before.tv_nsec) / 1e6;
+	spawnCount++;
+
+	children[pid] = child;
+	fds[child->outFd] = child;
+
+	epoll_event event;
+	event.events = EPOLLIN;
+	event.data.fd = child->outFd;
+	epoll_ctl(epollFd, EPOLL_CTL_ADD, child->outFd, &event);
+
+	if (child->pidFd >= 0) {
+		fds[child->pidFd] = child;
+		event.data.fd = child->pidFd;
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, child->pidFd, &event);
+	}
+
+	//the loop may be blocked without a timeout: let it pick up the new deadline.
+	if (limits.softTimeout > 0 || limits.hardTimeout > 0)
+		notify();
+
+	return child;
+}
+
+void ChildSupervisor::loop() {
+	while (running)
+		poll(-1);
+}
+
+void ChildSupervisor::handleOutput(Child* child) {
+	if (!child->outClosed) {
+		char buffer[4096];
+		ssize_t n;
+
+		while ((n = read(child->outFd, buffer, sizeof(buffer))) > 0)
+			child->scanner.feed(buffer, n);
+
+		//nothing after the verdict line matters, so do not wait for the trace.
+		if (killOnVerdict && child->scanner.getVerdict() != VERDICT_NONE)
+			kill(-child->pid, SIGKILL);
+
+		if (n < 0 && (errno == EAGAIN || errno == EINTR))
+			return;
+
+		//EOF or error: the child closed its end of the pipe.
+		fds.erase(child->outFd);
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, child->outFd, NULL);
+		close(child->outFd);
+		child->outClosed = true;
+
+		if (child->pidFd < 0) {
+			//no pidfd support on this kernel: reap this exact pid, never -1.
+			int status;
+			rusage usage;
+			if (wait4(child->pid, &status, 0, &usage) == child->pid) {
+				child->result.status = status;
+				child->result.cpuSeconds = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+						+ (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+				child->result.maxRssKb = usage.ru_maxrss;
+			}
+			child->exited = true;
+		}
+	}
+
+	//a queued child is freed here, so callers must not touch it afterwards.
+	if (child->exited)
+		finish(child);
+}
+
+void ChildSupervisor::handleExit(Child* child) {
+	int status;
+	rusage usage;
+
+	if (wait4(child->pid, &status, WNOHANG, &usage) != child->pid)
+		return;
+
+	child->result.status = status;
+	child->result.cpuSeconds = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+			+ (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+	child->result.maxRssKb = usage.ru_maxrss;
+	child->exited = true;
+
+	fds.erase(child->pidFd);
+	epoll_ctl(epollFd, EPOLL_CTL_DEL, child->pidFd, NULL);
+	close(child->pidFd);
+
+	//pick up whatever is still buffered in the pipe.
+	handleOutput(child);
+}
+
+void ChildSupervisor::checkNeeded() {
+	for (auto &c : children) {
+		Child* child = c.second;
+
+		if (child->done || child->result.aborted)
+			continue;
+
+		if (!child->isNeeded()) {
+			kill(-child->pid, SIGKILL);
+			child->result.aborted = true;
+		}
+	}
+
+	//execute() may be waiting for admission on behalf of a step that is gone.
+	finished.notify_all();
+}
+
+static double seconds_since(timespec& started) {
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (now.tv_sec - started.tv_sec) + (now.tv_nsec - started.tv_nsec) / 1e9;
+}
+
+//Milliseconds until the next timeout signal is due, capped by timeout (-1 is none).
+int ChildSupervisor::nextTimeout(int timeout) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (auto &c : children) {
+		Child* child = c.second;
+
+		if (child->done || child->exited || child->result.aborted)
+			continue;
+
+		double due = -1;
+		if (child->limits.softTimeout > 0 && !child->termSent)
+			due = child->limits.softTimeout;
+		else if (child->limits.hardTimeout > 0 && !child->killSent)
+			due = child->limits.hardTimeout;
+
+		if (due < 0)
+			continue;
+
+		if (child->suspended)
+			continue;
+
+		int ms = std::max(0, (int) ceil((due - elapsed(child)) * 1000));
+		if (timeout < 0 || ms < timeout)
+			timeout = ms;
+	}
+
+	return timeout;
+}
+
+//SIGTERM at the soft timeout lets ESBMC exit on its own; SIGKILL at the hard one does not.
+void ChildSupervisor::checkTimeouts() {
+	for (auto &c : children) {
+		Child* child = c.second;
+
+		if (child->done || child->exited || child->result.aborted || child->suspended)
+			continue;
+
+		double elapsed = this->elapsed(child);
+
+		if (child->limits.hardTimeout > 0 && elapsed >= child->limits.hardTimeout && !child->killSent) {
+			kill(-child->pid, SIGKILL);
+			child->killSent = true;
+			child->termSent = true;
+			child->result.timedOut = true;
+		} else if (child->limits.softTimeout > 0 && elapsed >= child->limits.softTimeout && !child->termSent) {
+			kill(-child->pid, SIGTERM);
+			child->termSent = true;
+			child->result.timedOut = true;
+		}
+	}
+}
+
+double ChildSupervisor::elapsed(Child* child) {
+	double paused = child->pausedSeconds;
+	if (child->suspended)
+		paused += seconds_since(child->suspendedAt);
+
+	return seconds_since(child->started) - paused;
+}
+
+//Children holding a slot: running (not suspended) or about to be spawned.
+int ChildSupervisor::active() {
+	int count = pending.size();
+
+	for (auto &c : children)
+		if (!c.second->done && !c.second->suspended)
+			count++;
+
+	return count;
+}
+
+//A step takes a free slot unless a suspended step is worth more; with none
+//free it takes the slot of a running step worth clearly less.
+bool ChildSupervisor::hasSlot(int step) {
+	if (slots == 0)
+		return true;
+
+	double worth = value(step);
+	Child* worst = NULL;
+	double worstValue = 0;
+	double suspendedValue = -1;
+
+	for (auto &c : children) {
+		Child* child = c.second;
+
+		if (child->done || child->exited || child->result.aborted)
+			continue;
+
+		double v = value(child->step);
+
+		if (child->suspended)
+			suspendedValue = std::max(suspendedValue, v);
+		else if (worst == NULL || v < worstValue) {
+			worst = child;
+			worstValue = v;
+		}
+	}
+
+	if (active() < slots)
+		return worth >= suspendedValue;
+
+	if (worst == NULL || worth <= worstValue * PREEMPT_MARGIN)
+		return false;
+
+	suspend(worst);
+
+	return true;
+}
+
+//Resumes the most valuable suspended steps into free slots, and swaps one in
+//for a running step worth clearly less, e.g. after the bounds have moved.
+void ChildSupervisor::rebalance() {
+	if (slots == 0)
+		return;
+
+	while (true) {
+		Child* best = NULL;
+		Child* worst = NULL;
+		double bestValue = -1;
+		double worstValue = 0;
+
+		for (auto &c : children) {
+			Child* child = c.second;
+
+			if (child->done || child->exited || child->result.aborted)
+				continue;
+
+			double v = value(child->step);
+
+			if (child->suspended && v > bestValue) {
+				best = child;
+				bestValue = v;
+			} else if (!child->suspended && (worst == NULL || v < worstValue)) {
+				worst = child;
+				worstValue = v;
+			}
+		}
+
+		if (best == NULL)
+			break;
+
+		if (active() < slots) {
+			double waitingValue = -1;
+			for (int step : waitingSteps)
+				waitingValue = std::max(waitingValue, value(step));
+
+			//a waiting step worth more takes the slot once it is woken up.
+			if (waitingValue >= bestValue)
+				break;
+
+			resume(best);
+			continue;
+		}
+
+		if (worst == NULL || bestValue <= worstValue * PREEMPT_MARGIN)
+			break;
+
+		suspend(worst);
+		resume(best);
+	}
+
+	finished.notify_all();
+}
+
+void ChildSupervisor::suspend(Child* child) {
+	child->frozen = !child->cgroup.empty() && cgroups->freeze(child->cgroup, true);
+	if (!child->frozen)
+		kill(-child->pid, SIGSTOP);
+
+	child->suspended = true;
+	clock_gettime(CLOCK_MONOTONIC, &child->suspendedAt);
+	suspensions++;
+}
+
+void ChildSupervisor::resume(Child* child) {
+	if (child->frozen)
+		cgroups->freeze(child->cgroup, false);
+	else
+		kill(-child->pid, SIGCONT);
+
+	child->suspended = false;
+	child->pausedSeconds += seconds_since(child->suspendedAt);
+}
+
+void ChildSupervisor::finish(Child* child) {
+	if (child->done)
+		return;
+
+	if (child->result.aborted)
+		abortedCpuSeconds += child->result.cpuSeconds;
+
+	if (child->suspended)
+		resume(child);
+
+	//time spent suspended was not the step's own.
+	child->result.wallSeconds = elapsed(child);
+
+	if (!child->cpus.empty())
+		topology->release(child->cpus);
+
+	if (!child->cgroup.empty()) {
+		long peakKb;
+		cgroups->release(child->cgroup, peakKb, child->result.outOfMemory);
+
+		if (peakKb > 0)
+			child->result.maxRssKb = peakKb;
+	}
+
+	child->scanner.finish();
+	child->result.verdict = child->scanner.getVerdict();
+
+	//no verdict: after a timeout the step is unknown, otherwise ESBMC broke.
+	if (child->result.verdict == VERDICT_NONE && !child->result.aborted)
+		child->result.verdict = child->result.timedOut ? VERDICT_UNKNOWN : VERDICT_ERROR;
+	child->result.output = child->scanner.getOutput();
+	child->result.witness = child->scanner.getWitness();
+	child->done = true;
+
+	if (child->queued) {
+		completions.push_back(child->result);
+		children.erase(child->pid);
+		delete child;
+	} else {
+		finished.notify_all();
+	}
+}
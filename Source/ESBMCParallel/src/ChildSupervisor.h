@@ -0,0 +1,176 @@
+/*
+ * ChildSupervisor.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef CHILDSUPERVISOR_H_
+#define CHILDSUPERVISOR_H_
+
+#include <sys/types.h>
+#include <time.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "VerdictScanner.h"
+#include "CgroupManager.h"
+#include "CpuTopology.h"
+
+struct ChildResult {
+	int step;
+	Verdict verdict;
+	std::string output;
+	std::vector<int> witness;
+	int status;
+	bool aborted;
+	double cpuSeconds;
+	double wallSeconds;
+	long maxRssKb;
+	bool cached;
+	bool timedOut;
+	bool outOfMemory;
+};
+
+//softTimeout: SIGTERM after that many seconds, hardTimeout: SIGKILL;
+//maxRunning: at most that many children, this one included, run while it
+//does; memoryKb: the predicted peak, reserved against the memory budget;
+//cpuWeight: the cgroup's cpu.weight; cpus: the CPUs a multi-threaded solver
+//is pinned to. 0 is no limit (or the default).
+struct StepLimits {
+	double softTimeout;
+	double hardTimeout;
+	int maxRunning;
+	long memoryKb;
+	int cpuWeight;
+	int cpus;
+};
+
+//Owns every ESBMC child: one epoll loop wakes on pipe data, child exit (pidfd)
+//or notify() (eventfd), so obsolete steps are killed as soon as they become obsolete.
+//Either start() a background loop and block in execute(), or drive it from a
+//single thread with launch(), poll() and nextCompletion() (reactor mode).
+//A child that runs past its soft or hard timeout ends as VERDICT_UNKNOWN.
+//With preemption, low-value children are suspended (cgroup freezer, or
+//SIGSTOP) for more valuable ones and resumed later, keeping their solver state.
+class ChildSupervisor {
+public:
+	ChildSupervisor();
+	virtual ~ChildSupervisor();
+
+	void start();
+	void stop();
+
+	ChildResult execute(int step, std::vector<std::string> arguments, std::function<bool()> isNeeded,
+			StepLimits limits = StepLimits { 0, 0, 0, 0, 0, 0 });
+	void notify();
+
+	pid_t launch(int step, std::vector<std::string> arguments, std::function<bool()> isNeeded,
+			StepLimits limits = StepLimits { 0, 0, 0, 0, 0, 0 });
+	//whether a child with these limits could start now.
+	bool admits(StepLimits limits);
+	void poll(int timeout);
+	bool nextCompletion(ChildResult& result);
+
+	void setOutputPolicy(size_t capacity, bool traceOnly, bool killOnVerdict);
+	void setWitness(std::string variable, int size);
+	//children go into leaves of these cgroups; memoryKb is the budget that
+	//admission keeps live and predicted usage under (0: none).
+	void setMemoryPolicy(CgroupManager* cgroups, long memoryKb);
+	//each child is pinned to a CPU of its own while there is one free.
+	void setPlacement(CpuTopology* topology);
+	//no child starts while this many run; the ones running are left alone. 0 is no limit.
+	void setRunningLimit(int limit);
+	int getRunning();
+	//at most slots children run at once; a step worth clearly more than the
+	//least valuable running one suspends it. 0 slots turns preemption off.
+	void setPreemption(int slots, std::function<double(int)> value);
+	int getSuspensions();
+
+	double getAbortedCpuSeconds();
+	double getSpawnMilliseconds();
+	int getSpawnCount();
+private:
+	struct Child {
+		Child(size_t capacity, bool traceOnly) : scanner(capacity, traceOnly) {}
+
+		pid_t pid;
+		int step;
+		int outFd;
+		int pidFd;
+		bool outClosed;
+		bool exited;
+		bool done;
+		bool queued;
+		timespec started;
+		StepLimits limits;
+		bool termSent;
+		bool killSent;
+		std::string cgroup;
+		std::vector<int> cpus;
+		bool suspended;
+		bool frozen;
+		timespec suspendedAt;
+		double pausedSeconds;
+		std::function<bool()> isNeeded;
+		VerdictScanner scanner;
+		ChildResult result;
+	};
+
+	Child* spawn(int step, std::vector<std::string> arguments, std::function<bool()> isNeeded, StepLimits limits,
+			bool queued);
+	bool isAdmitted(StepLimits limits);
+	long usedMemoryKb(long& largestKb);
+	long liveKb(Child* child);
+	int nextTimeout(int timeout);
+	void checkTimeouts();
+	double elapsed(Child* child);
+	int active();
+	bool hasSlot(int step);
+	void rebalance();
+	void suspend(Child* child);
+	void resume(Child* child);
+	void loop();
+	void handleOutput(Child* child);
+	void handleExit(Child* child);
+	void checkNeeded();
+	void finish(Child* child);
+
+	int epollFd;
+	int eventFd;
+	std::atomic<bool> running;
+	size_t outputCapacity;
+	bool traceOnly;
+	bool killOnVerdict;
+	std::string witnessVariable;
+	int witnessSize;
+	double abortedCpuSeconds;
+	double spawnMilliseconds;
+	int spawnCount;
+	int waiting;
+	std::multiset<int> pending;
+	long pendingKb;
+	CgroupManager* cgroups;
+	long memoryBudget;
+	CpuTopology* topology;
+	int runningLimit;
+	int slots;
+	std::function<double(int)> value;
+	std::multiset<int> waitingSteps;
+	int suspensions;
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable finished;
+	std::map<int, Child*> children;
+	std::map<int, Child*> fds;
+	std::deque<ChildResult> completions;
+};
+
+#endif /* CHILDSUPERVISOR_H_ */
@@ -0,0 +1,212 @@
+/*
+ * CpuTopology.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "CpuTopology.h"
+
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+
+//from <numaif.h>, so that libnuma is not needed.
+#define MPOL_DEFAULT 0
+#define MPOL_PREFERRED 1
+
+static int read_number(std::string path, int fallback) {
+	std::ifstream file(path);
+	int value;
+
+	if (file >> value)
+		return value;
+
+	return fallback;
+}
+
+//"0-3,8-11" -> 0 1 2 3 8 9 10 11
+static std::vector<int> parse_list(std::string list) {
+	std::vector<int> values;
+	std::istringstream ranges(list);
+	std::string range;
+
+	while (std::getline(ranges, range, ',')) {
+		if (range.empty() || range == "\n")
+			continue;
+
+		int first = atoi(range.c_str());
+		size_t dash = range.find('-');
+		int last = dash == std::string::npos ? first : atoi(range.c_str() + dash + 1);
+
+		for (int value = first; value <= last; value++)
+			values.push_back(value);
+	}
+
+	return values;
+}
+
+static int set_mempolicy(int mode, unsigned long* mask, unsigned long maxnode) {
+	return syscall(SYS_set_mempolicy, mode, mask, maxnode);
+}
+
+CpuTopology::CpuTopology() {
+	this->cores = 0;
+	this->nodes = 0;
+}
+
+CpuTopology::~CpuTopology() {
+
+}
+
+bool CpuTopology::load() {
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+		return false;
+
+	std::map<int, int> nodeOf;
+	std::ifstream online("/sys/devices/system/node/online");
+	std::string list;
+
+	if (std::getline(online, list)) {
+		for (int node : parse_list(list)) {
+			std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+			std::string cpus;
+
+			if (std::getline(cpulist, cpus))
+				for (int cpu : parse_list(cpus))
+					nodeOf[cpu] = node;
+		}
+	}
+
+	std::vector<Cpu> cpus;
+	std::map<std::pair<int, int>, int> threads;
+	std::set<int> usedNodes;
+
+	for (int id = 0; id < CPU_SETSIZE; id++) {
+		if (!CPU_ISSET(id, &allowed))
+			continue;
+
+		std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(id) + "/topology/";
+
+		Cpu cpu;
+		cpu.id = id;
+		cpu.node = nodeOf.count(id) > 0 ? nodeOf[id] : 0;
+		cpu.package = read_number(topology + "physical_package_id", 0);
+		cpu.core = read_number(topology + "core_id", id);
+		//0 for the first allowed SMT sibling of a core, 1 for the next, ...
+		cpu.thread = threads[std::make_pair(cpu.package, cpu.core)]++;
+
+		cpus.push_back(cpu);
+		usedNodes.insert(cpu.node);
+	}
+
+	//one CPU from every core before any second sibling, node by node.
+	std::sort(cpus.begin(), cpus.end(), [](const Cpu& a, const Cpu& b) {
+		if (a.thread != b.thread)
+			return a.thread < b.thread;
+		if (a.node != b.node)
+			return a.node < b.node;
+		if (a.package != b.package)
+			return a.package < b.package;
+		return a.core < b.core;
+	});
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	order = cpus;
+	busy.assign(order.size(), false);
+	cores = threads.size();
+	nodes = usedNodes.size();
+
+	return !order.empty();
+}
+
+int CpuTopology::getCpus() {
+	return order.size();
+}
+
+int CpuTopology::getCores() {
+	return cores;
+}
+
+int CpuTopology::getNodes() {
+	return nodes;
+}
+
+//Several CPUs for one child come in placement order: whole cores first, on
+//as few nodes as possible.
+std::vector<int> CpuTopology::acquire(int count) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::vector<size_t> free;
+	for (size_t i = 0; i < order.size() && (int) free.size() < count; i++)
+		if (!busy[i])
+			free.push_back(i);
+
+	std::vector<int> cpus;
+	if ((int) free.size() < count)
+		return cpus;
+
+	for (size_t i : free) {
+		busy[i] = true;
+		cpus.push_back(order[i].id);
+	}
+
+	return cpus;
+}
+
+void CpuTopology::release(std::vector<int> cpus) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (size_t i = 0; i < order.size(); i++)
+		if (std::find(cpus.begin(), cpus.end(), order[i].id) != cpus.end())
+			busy[i] = false;
+}
+
+int CpuTopology::getNode(int cpu) {
+	for (auto &c : order)
+		if (c.id == cpu)
+			return c.node;
+
+	return 0;
+}
+
+//Affinity and memory policy are both per thread and inherited by a child,
+//so no other worker is affected.
+void CpuTopology::apply(std::vector<int> cpus) {
+	cpu_set_t mask;
+	CPU_ZERO(&mask);
+	for (int cpu : cpus)
+		CPU_SET(cpu, &mask);
+	sched_setaffinity(0, sizeof(mask), &mask);
+
+	if (nodes > 1) {
+		unsigned long nodemask[16] = { 0 };
+		int node = getNode(cpus[0]);
+
+		nodemask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+		set_mempolicy(MPOL_PREFERRED, nodemask, 8 * sizeof(nodemask));
+	}
+}
+
+void CpuTopology::restore() {
+	cpu_set_t mask;
+	CPU_ZERO(&mask);
+
+	for (auto &c : order)
+		CPU_SET(c.id, &mask);
+
+	sched_setaffinity(0, sizeof(mask), &mask);
+
+	if (nodes > 1)
+		set_mempolicy(MPOL_DEFAULT, NULL, 0);
+}
@@ -0,0 +1,52 @@
+/*
+ * CpuTopology.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef CPUTOPOLOGY_H_
+#define CPUTOPOLOGY_H_
+
+#include <mutex>
+#include <vector>
+
+//The CPUs this process may run on (sched_getaffinity) and how sysfs groups
+//them into cores, packages and NUMA nodes. Children are placed one per
+//physical core before any SMT sibling is used, filling NUMA nodes in order.
+class CpuTopology {
+public:
+	CpuTopology();
+	virtual ~CpuTopology();
+
+	bool load();
+
+	int getCpus();
+	int getCores();
+	int getNodes();
+
+	//count free CPUs, empty when there are not that many left.
+	std::vector<int> acquire(int count);
+	void release(std::vector<int> cpus);
+	int getNode(int cpu);
+
+	//pins the calling thread, and with several nodes prefers the first CPU's
+	//memory, so a child spawned from it inherits both; restore() undoes it.
+	void apply(std::vector<int> cpus);
+	void restore();
+private:
+	struct Cpu {
+		int id;
+		int node;
+		int package;
+		int core;
+		int thread;
+	};
+
+	std::vector<Cpu> order;
+	std::vector<bool> busy;
+	int cores;
+	int nodes;
+	std::mutex mutex;
+};
+
+#endif /* CPUTOPOLOGY_H_ */
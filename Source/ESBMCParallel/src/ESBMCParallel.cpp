@@ -32,13 +32,29 @@
 #include <signal.h>
 #include <sstream>
 #include <algorithm>
-#include <fcntl.h>
-#include <poll.h>
+#include <map>
+#include <set>
+#include <deque>
+#include <fstream>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "ParallelController.h"
-
-#define READ 0
-#define WRITE 1
+#include "ChildSupervisor.h"
+#include "Benchmark.h"
+#include "StepCache.h"
+#include "RuntimeModel.h"
+#include "StepDispenser.h"
+#include "HedgeTracker.h"
+#include "RetryLadder.h"
+#include "CgroupManager.h"
+#include "CpuTopology.h"
+#include "LoadGovernor.h"
+#include "RunHistory.h"
 
 enum Order { ASC, DESC };
 
@@ -46,66 +62,47 @@ std::time_t start;
 std::string executable = "./esbmc";
 std::string filename;
 std::string esbmc_parameters = "--boolector --quiet";
-
-pid_t popen2(const char *command, int *infp, int *outfp) {
-	int p_stdin[2], p_stdout[2];
-	pid_t pid;
-
-	if (pipe(p_stdin) != 0 || pipe(p_stdout) != 0)
-		return -1;
-
-	pid = fork();
-
-	if (pid < 0)
-		return pid;
-	else if (pid == 0) {
-		setpgid(0, 0);
-
-		dup2(p_stdin[READ], STDIN_FILENO);
-		dup2(p_stdout[WRITE], STDOUT_FILENO);
-
-		//close unuse descriptors on child process.
-		close(p_stdin[READ]);
-		close(p_stdin[WRITE]);
-		close(p_stdout[READ]);
-		close(p_stdout[WRITE]);
-
-		//can change to any exec* function family.
-		execl("/bin/bash", "bash", "-c", command, NULL);
-		perror("execl");
-		exit(1);
-	}
-
-	// close unused descriptors on parent process.
-	close(p_stdin[READ]);
-	close(p_stdout[WRITE]);
-
-	if (infp == NULL)
-		close(p_stdin[WRITE]);
-	else
-		*infp = p_stdin[WRITE];
-
-	if (outfp == NULL)
-		close(p_stdout[READ]);
-	else
-		*outfp = p_stdout[READ];
-
-	return pid;
-}
-
-int pclose2(FILE * fp, pid_t pid) {
-	int stat;
-
-	fclose(fp);
-	while (waitpid(pid, &stat, 0) == -1) {
-		if (errno != EINTR) {
-			stat = -1;
-			break;
-		}
-	}
-
-	return stat;
-}
+ChildSupervisor supervisor;
+Benchmark benchmark;
+StepCache cache;
+RuntimeModel runtimeModel;
+RetryLadder retryLadder;
+CgroupManager cgroups;
+CpuTopology topology;
+//the same kernel average as the runtime model, over peak kB instead of seconds.
+RuntimeModel memoryModel;
+RunHistory runHistory;
+bool monotoneQuery = false;
+bool monotoneMacro = false;
+int bestPartitionValue = -1;
+std::vector<int> bestPartition;
+int jobs = 0;
+bool filtered = false;
+bool karySplit = false;
+bool costSelect = false;
+bool gallopSearch = false;
+bool gallopDown = false;
+int gallopHint = 0;
+bool bidirectional = false;
+bool anytime = false;
+double gapLimit = -1;
+bool gapPercent = false;
+std::string lastBounds;
+int deadline = 0;
+std::chrono::steady_clock::time_point deadlineAt;
+std::atomic<bool> searching(false);
+std::mutex watchdogMutex;
+std::condition_variable watchdogWake;
+int lastProjected = -1;
+std::string hedgeSolver;
+int preemptSpare = 0;
+//how idle cores are given to steps in flight: none, portfolio or threads.
+std::string allocation = "none";
+std::vector<std::string> portfolioSolvers;
+std::string threadFlags;
+std::vector<int> domain;
+std::set<int> unresolvedSteps;
+volatile sig_atomic_t jobsDelta = 0;
 
 void writeLog(int core, std::string log) {
 	std::time_t end = std::time(NULL);
@@ -128,88 +125,194 @@ std::string execute_cmd(std::string command) {
 	return result;
 }
 
-std::string execute_cmd_with_abort(ParallelController* controller, int core, int step, std::string command) {
-	int status;
-	int fd;
-	pollfd pollfd[1];
-	pid_t pid = popen2(command.c_str(), NULL, &fd);
+bool is_solver_flag(std::string parameter) {
+	return parameter.find("--") == 0 && RetryLadder::isSolver(parameter.substr(2));
+}
+
+//flags are appended to esbmc_parameters; a solver flag among them replaces
+//the one there.
+std::vector<std::string> arguments_for_step(int step, std::string flags = "") {
+	std::vector<std::string> arguments;
+	arguments.push_back(executable);
+	arguments.push_back(filename);
+
+	std::vector<std::string> extra;
+	bool solver = false;
+
+	std::istringstream words(flags);
+	std::string word;
+	while (words >> word) {
+		extra.push_back(word);
+		solver = solver || is_solver_flag(word);
+	}
 
-	int flags;
-	flags = fcntl(fd, F_GETFL, 0);
-	flags |= O_NONBLOCK | FASYNC;
-	fcntl(fd, F_SETFL, flags);
+	std::istringstream parameters(esbmc_parameters);
+	std::string parameter;
+	while (parameters >> parameter)
+		if (!solver || !is_solver_flag(parameter))
+			arguments.push_back(parameter);
 
-	pollfd[0].fd = fd;
-	pollfd[0].events = POLL_IN;
+	arguments.insert(arguments.end(), extra.begin(), extra.end());
 
-	char buffer[128];
-	std::string result = "";
-	while (1) {
+	if (monotoneMacro)
+		arguments.push_back("-DMONOTONE_QUERY");
 
-		poll(pollfd, 1, 1000);
+	arguments.push_back("-Dvalordeh=" + std::to_string(step));
 
-		if (pollfd[0].revents & POLLHUP) //EOF
-			break;
-		else if (pollfd[0].revents & POLLIN) { //read
-			while (read(fd, buffer, 128) > 0)
-				result += buffer;
-		}
+	return arguments;
+}
+
+bool is_decisive(ChildResult& result) {
+	return result.verdict == VERDICT_FAILED || result.verdict == VERDICT_SUCCESSFUL;
+}
+
+std::string describe_verdict(ChildResult& result) {
+	if (result.verdict == VERDICT_FAILED)
+		return "False";
+	if (result.verdict == VERDICT_SUCCESSFUL)
+		return "True";
+	if (result.verdict == VERDICT_UNKNOWN)
+		return result.timedOut ? "Unknown (timeout)" : "Unknown";
+	if (result.outOfMemory)
+		return "Error (out of memory)";
+
+	if (result.status < 0)
+		return "Error (not started)";
+	if (WIFSIGNALED(result.status))
+		return "Error (signal " + std::to_string(WTERMSIG(result.status)) + ")";
+
+	return "Error (exit " + std::to_string(WEXITSTATUS(result.status)) + ")";
+}
+
+//The predicted peak plus 20% headroom; 0 until some step has been measured.
+long predict_memory(int step) {
+	if (memoryModel.getSamples() == 0)
+		return 0;
+
+	return (long) (memoryModel.predict(step) * 1.2);
+}
 
-		if (!controller->isStepNeeded(step)) {
-			writeLog(core, "Abort Step " + std::to_string(step));
+//flags with their solver flag, if any, swapped for solver; the other flags stay.
+std::string with_solver(std::string flags, std::string solver) {
+	if (solver.empty())
+		return flags;
 
-			kill(-pid, SIGKILL);
+	std::istringstream words(flags);
+	std::string word;
+	std::string result;
 
-			while ((waitpid(-1, &status, WNOHANG)) > 0)
-				sleep(1);
+	while (words >> word)
+		if (!is_solver_flag(word))
+			result += word + " ";
 
+	return result + solver;
+}
+
+void observe_memory(ChildResult& result) {
+	//an aborted run never reached its peak.
+	if (!result.aborted && !result.cached && result.maxRssKb > 0)
+		memoryModel.observe(result.step, result.maxRssKb);
+}
+
+//A cached verdict stands in for the run; fresh verdicts are added to the cache.
+//An UNKNOWN or ERROR run climbs the retry ladder while the step is still needed.
+//flags and cpus describe the copy (a hedge, a portfolio solver or a
+//multi-threaded restart); cpuWeight is its cgroup's share, 0 for the default.
+ChildResult execute_step(int core, int step, std::function<bool()> isNeeded, std::string flags = "",
+		int cpuWeight = 0, int cpus = 0) {
+	ChildResult result;
+
+	if (cache.lookup(step, result)) {
+		writeLog(core, "Cached Step " + std::to_string(step));
+		return result;
+	}
+
+	for (int attempt = 0; attempt < retryLadder.getAttempts(); attempt++) {
+		Attempt current = retryLadder.getAttempt(attempt);
+		current.limits.memoryKb = predict_memory(step);
+		current.limits.cpuWeight = cpuWeight;
+		current.limits.cpus = cpus;
+
+		if (attempt == 0)
+			writeLog(core, "Started Step " + std::to_string(step));
+		else
+			writeLog(core, "Retry Step " + std::to_string(step) + " after " + describe_verdict(result) + " ("
+					+ retryLadder.describe(attempt) + ")");
+
+		result = supervisor.execute(step, arguments_for_step(step, with_solver(flags, current.solver)), isNeeded,
+				current.limits);
+		observe_memory(result);
+
+		if (result.aborted || is_decisive(result) || !isNeeded())
 			break;
-		}
 	}
 
-	close(fd);
+	cache.store(result);
 
 	return result;
 }
 
-void execute_binary_search(int hmin, int hmax, int cores) {
-	std::vector<int> founds;
+//Re-evaluates a counterexample's partition against the instance data.
+//Returns its real objective value, or -1 when there is no usable witness.
+int record_witness(int core, ChildResult& result) {
+	if (result.verdict != VERDICT_FAILED || result.witness.empty())
+		return -1;
 
-	ParallelController controller(hmin, hmax);
+	Evaluation evaluation = benchmark.evaluate(result.witness);
 
-#pragma omp parallel for
-	for (int thread = 0; thread < cores - 1; thread++) {
+	if (!evaluation.valid || evaluation.fobj > result.step)
+		return -1;
 
-		while (true) {
-			int step = 0;
+	writeLog(core, "Witness Step " + std::to_string(result.step) + " > fobj=" + std::to_string(evaluation.fobj)
+			+ " softcost=" + std::to_string(evaluation.softcost) + " comcost=" + std::to_string(evaluation.comcost));
 
-#pragma omp critical
-			step = controller.getNextStep();
+#pragma omp critical(witness)
+	if (bestPartitionValue < 0 || evaluation.fobj < bestPartitionValue) {
+		bestPartitionValue = evaluation.fobj;
+		bestPartition = result.witness;
+	}
 
-			if (step == 0)
-				break;
+	return evaluation.fobj;
+}
 
-			writeLog(thread, "Started Step " + std::to_string(step));
+//Steps are addressed by index so that, once the reachable-objective filter is
+//on, the methods only ever hand out values some partition can actually hit.
+int domain_size(int hmin, int hmax) {
+	if (filtered)
+		return domain.size();
 
-			std::string command_line = executable + " " + filename + " " + esbmc_parameters + " -Dvalordeh=" + std::to_string(step);
-			std::string result = execute_cmd_with_abort(&controller, thread, step, command_line);
+	return std::max(0, hmax - hmin + 1);
+}
 
-			std::size_t verification_failed = result.find("VERIFICATION FAILED");
+int domain_step(int hmin, int index) {
+	if (filtered)
+		return domain[index];
 
-			if (verification_failed != std::string::npos) {
-				founds.push_back(step);
-				writeLog(thread, "Finished Step " + std::to_string(step) + " > False");
+	return hmin + index;
+}
 
-#pragma omp critical
-				controller.setStepResult(step, false);
-			} else {
-#pragma omp critical
-				controller.setStepResult(step, true);
-				writeLog(thread, "Finished Step " + std::to_string(step) + " > True");
-			}
-		}
-	}
+int domain_index(int hmin, int step) {
+	if (filtered)
+		return std::lower_bound(domain.begin(), domain.end(), step) - domain.begin();
+
+	return step - hmin;
+}
+
+//Steps that stayed UNKNOWN or ERROR on every rung of the retry ladder and
+//could still hold the optimum.
+void report_unresolved(std::vector<int> steps) {
+	if (steps.empty())
+		return;
 
+	std::sort(steps.begin(), steps.end());
+
+	std::cout << "Unresolved steps:";
+	for (int step : steps)
+		std::cout << " " << step;
+	std::cout << " (the optimum is not proven)" << std::endl;
+}
+
+void report_best_solution(std::vector<int>& founds) {
 	if (founds.size() > 0) {
 		int cLower = *std::min_element(founds.begin(), founds.end());
 
@@ -217,171 +320,803 @@ void execute_binary_search(int hmin, int hmax, int cores) {
 		long time = end - start;
 
 		std::cout << std::endl;
-		std::cout << "The best solution is: " << std::to_string(cLower)
-				<< " in " << time << "s" << std::endl;
+		std::cout << "The best solution is: " << std::to_string(cLower) << " in " << time << "s" << std::endl;
+
+		if (bestPartitionValue == cLower) {
+			std::cout << "Partition: x = {";
+			for (size_t i = 0; i < bestPartition.size(); i++)
+				std::cout << (i == 0 ? " " : ", ") << bestPartition[i];
+			std::cout << " }" << std::endl;
+		}
 	} else {
 		std::cout << std::endl;
 		std::cout << "No solution found:(" << std::endl;
 	}
 }
 
-void execute_sequential_opt_search(int hmin, int hmax, int cores, Order order) {
-	std::vector<int> founds;
-	bool stop = false;
+long available_memory_kb() {
+	std::ifstream meminfo("/proc/meminfo");
+	std::string name;
+	long kb;
+	std::string unit;
+
+	while (meminfo >> name >> kb >> unit)
+		if (name == "MemAvailable:")
+			return kb;
+
+	return 0;
+}
+
+//"8G", "512M", "1048576K"; a bare number is in megabytes.
+long parse_memory_kb(std::string size) {
+	char* unit;
+	double value = strtod(size.c_str(), &unit);
 
-	if(order == DESC)
-		hmin = hmax + 1;
+	if (unit == size.c_str() || value <= 0)
+		return -1;
+
+	std::string suffix = unit;
+	if (suffix == "G" || suffix == "g")
+		return value * 1024 * 1024;
+	if (suffix == "M" || suffix == "m" || suffix.empty())
+		return value * 1024;
+	if (suffix == "K" || suffix == "k")
+		return value;
+
+	return -1;
+}
+
+void on_jobs_signal(int signal) {
+	if (signal == SIGUSR1)
+		jobsDelta = jobsDelta + 1;
 	else
-		hmin--;
+		jobsDelta = jobsDelta - 1;
+}
 
-#pragma omp parallel for
-	for (int thread = 0; thread < cores - 1; thread++) {
+//Reactor mode: this thread alone keeps up to `jobs` ESBMC children in flight
+//through the supervisor's completion queue. SIGUSR1/SIGUSR2 grow/shrink `jobs`.
+//Retries of UNKNOWN or ERROR steps go before new steps.
+void run_reactor(std::function<int()> nextStep, std::function<bool(int)> isStepNeeded,
+		std::function<void(int, ChildResult&)> onResult) {
+	std::map<int, int> running;
+	std::map<int, int> attempts;
+	std::deque<ChildResult> retries;
+	std::vector<bool> slots;
+	bool exhausted = false;
+
+	while (true) {
+		if (jobsDelta != 0) {
+			jobs = std::max(1, jobs + jobsDelta);
+			jobsDelta = 0;
+			writeLog(0, "Jobs " + std::to_string(jobs));
+		}
 
-		while (true) {
+		while ((int) running.size() < jobs) {
 			int step = 0;
+			int attempt = 0;
+			ChildResult previous;
 
-			if(order == ASC) {
-#pragma omp critical
-				hmin++;
-				step = hmin;
-			}
-			else {
-#pragma omp critical
-				hmin--;
-				step = hmin;
+			if (!retries.empty()) {
+				previous = retries.front();
+				step = previous.step;
+				attempt = attempts[step];
+
+				if (!isStepNeeded(step)) {
+					retries.pop_front();
+					attempts.erase(step);
+					onResult(0, previous);
+					continue;
+				}
+
+				//a retry waits for its turn rather than let new steps past it.
+				Attempt retry = retryLadder.getAttempt(attempt);
+				retry.limits.memoryKb = predict_memory(step);
+
+				if (!supervisor.admits(retry.limits))
+					break;
+
+				retries.pop_front();
+			} else {
+				//the next step is not known yet, so admit it on the largest prediction.
+				Attempt first = retryLadder.getAttempt(0);
+				first.limits.memoryKb = memoryModel.getSamples() > 0 ? (long) (memoryModel.getMaximum() * 1.2) : 0;
+
+				if (exhausted || !supervisor.admits(first.limits))
+					break;
+
+				step = nextStep();
+
+				if (step == 0) {
+					exhausted = true;
+					break;
+				}
+
+				ChildResult cached;
+				if (cache.lookup(step, cached)) {
+					writeLog(0, "Cached Step " + std::to_string(step));
+					onResult(0, cached);
+					continue;
+				}
 			}
 
-			if (step > hmax || step < hmin)
-				break;
+			Attempt current = retryLadder.getAttempt(attempt);
+			current.limits.memoryKb = predict_memory(step);
+
+			int slot = std::find(slots.begin(), slots.end(), false) - slots.begin();
+			if (slot == (int) slots.size())
+				slots.push_back(true);
+			else
+				slots[slot] = true;
+
+			if (attempt == 0)
+				writeLog(slot, "Started Step " + std::to_string(step));
+			else
+				writeLog(slot, "Retry Step " + std::to_string(step) + " after " + describe_verdict(previous) + " ("
+						+ retryLadder.describe(attempt) + ")");
+
+			if (supervisor.launch(step, arguments_for_step(step, current.solver),
+					[isStepNeeded, step] { return isStepNeeded(step); }, current.limits) < 0) {
+				slots[slot] = false;
+				attempts.erase(step);
+
+				ChildResult failed { step, VERDICT_ERROR, "", std::vector<int>(), -1, false, 0, 0, 0, false, false, false };
+				onResult(slot, failed);
+				continue;
+			}
 
-			if(stop)
-				break;
+			running[step] = slot;
+		}
 
-			writeLog(thread, "Started Step " + std::to_string(step));
+		if (running.empty() && retries.empty())
+			break;
 
-			std::string command_line = executable + " " + filename + " " + esbmc_parameters + " -Dvalordeh=" + std::to_string(step);
-			std::string result = execute_cmd(command_line);
+		supervisor.poll(-1);
 
-			std::size_t verification_failed = result.find("VERIFICATION FAILED");
+		ChildResult result;
+		while (supervisor.nextCompletion(result)) {
+			int slot = running[result.step];
+			running.erase(result.step);
+			slots[slot] = false;
 
-			if (verification_failed != std::string::npos) {
-				if(order == ASC)
-					stop = true;
+			cache.store(result);
+			observe_memory(result);
+			exhausted = false;
 
-				founds.push_back(step);
-				writeLog(thread, "Finished Step " + std::to_string(step) + " > False");
-			} else {
-				if(order == DESC)
-					stop = true;
+			int attempt = attempts[result.step];
 
-				writeLog(thread, "Finished Step " + std::to_string(step) + " > True");
+			if (!result.aborted && !is_decisive(result) && attempt + 1 < retryLadder.getAttempts()
+					&& isStepNeeded(result.step)) {
+				attempts[result.step] = attempt + 1;
+				retries.push_back(result);
+				continue;
 			}
+
+			attempts.erase(result.step);
+
+			if (result.aborted)
+				writeLog(slot, "Abort Step " + std::to_string(result.step));
+
+			onResult(slot, result);
 		}
 	}
+}
 
-	if (founds.size() > 0) {
-		int cLower = *std::min_element(founds.begin(), founds.end());
-		//if(order == DESC)
-		//	cLower--;
+void handle_binary_result(ParallelController* controller, std::vector<int>* founds, int core, ChildResult& result) {
+	int step = result.step;
 
-		time_t end = std::time(NULL);
-		long time = end - start;
+	if (result.aborted) {
+		controller->releaseStep(step);
+		return;
+	}
 
-		std::cout << std::endl;
-		std::cout << "The best solution is: " << std::to_string(cLower) << " in " << time << "s" << std::endl;
+	if (!result.cached && is_decisive(result))
+		runtimeModel.observe(step, result.wallSeconds);
+
+	if (result.verdict == VERDICT_FAILED) {
+#pragma omp critical(founds)
+		founds->push_back(step);
+		writeLog(core, "Finished Step " + std::to_string(step) + " > False");
+
+		controller->setStepResult(step, false);
+
+		//the witness may be strictly better than the bound it was found under.
+		int fobj = record_witness(core, result);
+		if (fobj >= 0 && fobj < step) {
+#pragma omp critical(founds)
+			founds->push_back(fobj);
+			controller->setSolution(fobj);
+		}
+	} else if (result.verdict == VERDICT_SUCCESSFUL) {
+		controller->setStepResult(step, true);
+		writeLog(core, "Finished Step " + std::to_string(step) + " > True");
 	} else {
-		std::cout << std::endl;
-		std::cout << "No solution found:(" << std::endl;
+		//no answer: the step stays open and must not move the bounds.
+		controller->setStepUnknown(step);
+		writeLog(core, "Finished Step " + std::to_string(step) + " > " + describe_verdict(result));
+	}
+}
+
+//Replays cached verdicts so the controller starts from the known bounds.
+void seed_from_cache(ParallelController* controller, std::vector<int>* founds, int hmin, int hmax) {
+	for (int step : cache.getSteps()) {
+		ChildResult result;
+
+		if (step < hmin || step > hmax || !controller->isStepNeeded(step) || !cache.lookup(step, result))
+			continue;
+
+		writeLog(0, "Cached Step " + std::to_string(step));
+		handle_binary_result(controller, founds, 0, result);
 	}
 }
 
-void execute_sequential_search_worker(int step, std::vector<int>* founds, Order order) {
-	writeLog(0, "Started Step " + std::to_string(step));
+//Anytime mode: logs the bounds whenever they move, and stops the search,
+//killing every child, once they are within --gap.
+void report_bounds(ParallelController* controller, int core) {
+	if (!anytime)
+		return;
 
-	std::string command_line = " { time " + executable + " " + filename + " " + esbmc_parameters + " -Dvalordeh=" + std::to_string(step) + "; } 2>> /dev/null";
+	int lower, upper;
+	bool feasible = controller->getBounds(lower, upper);
 
-	std::string result = execute_cmd(command_line);
-	std::size_t verification_failed = result.find("VERIFICATION FAILED");
-	if ( verification_failed != std::string::npos ){
-		if(order == ASC)
-			(*founds).push_back(step);
+	std::string bounds = "Bounds [" + std::to_string(lower) + ", " + (feasible ? std::to_string(upper) : "none") + "]";
+	double gap = upper - lower;
+	double percent = upper > 0 ? 100.0 * gap / upper : 0;
 
-		writeLog(0, "Finished Step " + std::to_string(step) + " > False");
-	} else {
-		if(order == DESC)
-			(*founds).push_back(step);
+	if (feasible) {
+		std::ostringstream text;
+		text.precision(3);
+		text << " gap " << gap << " (" << percent << "%)";
+		bounds += text.str();
+	}
+
+	bool changed = false;
 
-		writeLog(0, "Finished Step " + std::to_string(step) + " > True");
+#pragma omp critical(bounds)
+	if (bounds != lastBounds) {
+		lastBounds = bounds;
+		changed = true;
+	}
+
+	if (changed)
+		writeLog(core, bounds);
+
+	if (feasible && gapLimit >= 0 && (gapPercent ? percent : gap) <= gapLimit && gap > 0 && controller->stop()) {
+		writeLog(core, "Gap reached, stopping");
+		supervisor.notify();
 	}
 }
 
-void execute_sequential_search(int hmin, int hmax, int cores, Order order) {
-	std::vector<int> founds;
+void report_gap(ParallelController* controller) {
+	if (!anytime)
+		return;
+
+	int lower, upper;
+	bool feasible = controller->getBounds(lower, upper);
+
+	if (feasible && lower < upper)
+		std::cout << "Proven lower bound: " << lower << " (gap " << upper - lower << ")" << std::endl;
+	else if (!feasible)
+		std::cout << "Proven lower bound: " << lower << std::endl;
+}
+
+double seconds_to_deadline() {
+	return std::chrono::duration<double>(deadlineAt - std::chrono::steady_clock::now()).count();
+}
+
+//Deadline mode: projects how far the bracket can still shrink, from the
+//runtime model near its middle and the rounds left. When the optimum is out
+//of reach, every worker is put on the same round (k-ary split), which
+//removes the most of the interval per unit of wall time. How many steps run
+//at once is left to --jobs and the load governor, which sets the same
+//running limit from measured pressure; a second setter would fight it.
+void plan_deadline(ParallelController* controller, int core) {
+	if (deadline <= 0 || seconds_to_deadline() <= 0)
+		return;
+
+	int lower, upper;
+	controller->getBounds(lower, upper);
+
+	double gap = upper - lower;
+	if (gap <= 0)
+		return;
+
+	double stepSeconds = runtimeModel.predict(lower + (upper - lower) / 2);
+	double rounds = std::max(0.0, seconds_to_deadline()) / stepSeconds;
+	double projected = gap / pow(jobs + 1.0, rounds);
 
-	int current = hmin;
-	int target = current + (cores - 2);
+	if (projected < 1)
+		return;
 
-	if(order == DESC) {
-		current = hmax;
-		target = current - (cores - 2);
+	bool switched = false;
+
+#pragma omp critical(deadline)
+	if (!karySplit && !costSelect && jobs > 1) {
+		karySplit = true;
+		switched = true;
 	}
 
-	do {
-		if(order == ASC) {
-			#pragma omp parallel for
-			for(int thread = current; thread <= target; thread++){
-				execute_sequential_search_worker(thread, &founds, order);
-			}
-		} else {
-			#pragma omp parallel for
-			for(int thread = current; thread >= target; thread--){
-				execute_sequential_search_worker(thread, &founds, order);
+	if (switched) {
+		controller->setKary(jobs);
+		writeLog(core, "Deadline: optimum out of reach, splitting k-ary");
+	}
+
+	int expected = ceil(projected);
+	bool changed = false;
+
+#pragma omp critical(deadline)
+	if (expected != lastProjected) {
+		lastProjected = expected;
+		changed = true;
+	}
+
+	if (changed)
+		writeLog(core, "Deadline: " + std::to_string((int) seconds_to_deadline()) + "s left, expected gap "
+				+ std::to_string(expected));
+}
+
+//Stops the search at the deadline; the bracket proven so far is kept.
+std::thread start_watchdog(ParallelController* controller) {
+	searching = true;
+
+	if (deadline <= 0)
+		return std::thread();
+
+	return std::thread([controller] {
+		std::unique_lock<std::mutex> lock(watchdogMutex);
+
+		if (watchdogWake.wait_until(lock, deadlineAt, [] { return !searching; }))
+			return;
+
+		if (controller->stop()) {
+			writeLog(0, "Deadline reached, stopping");
+			supervisor.notify();
+		}
+	});
+}
+
+void stop_watchdog(std::thread& watchdog) {
+	{
+		std::lock_guard<std::mutex> lock(watchdogMutex);
+		searching = false;
+		watchdogWake.notify_all();
+	}
+
+	if (watchdog.joinable())
+		watchdog.join();
+}
+
+void configure_controller(ParallelController* controller, std::vector<int>* founds, int hmin, int hmax) {
+	controller->setNotifier([] { supervisor.notify(); });
+	controller->setMonotone(monotoneQuery);
+
+	if (filtered)
+		controller->setDomain(domain);
+
+	if (gallopSearch)
+		controller->setGallop(gallopDown, gallopHint);
+
+	if (karySplit)
+		controller->setKary(jobs);
+
+	if (costSelect || deadline > 0) {
+		//earlier runs of the same model are the best prior there is.
+		runtimeModel.setRange(hmin, hmax);
+		for (auto &result : cache.getResults())
+			runtimeModel.observe(result.step, result.wallSeconds);
+	}
+
+	if (costSelect)
+		controller->setCostModel([](int step) { return runtimeModel.predict(step); });
+
+	seed_from_cache(controller, founds, hmin, hmax);
+	plan_deadline(controller, 0);
+}
+
+void execute_binary_search_reactor(int hmin, int hmax) {
+	std::vector<int> founds;
+
+	ParallelController controller(hmin, hmax);
+	configure_controller(&controller, &founds, hmin, hmax);
+
+	std::thread watchdog = start_watchdog(&controller);
+
+	int turn = 0;
+
+	//bidirectional: the freed slots take turns between the two end scans and,
+	//with three jobs or more, the bisection of the interior.
+	run_reactor([&controller, &turn] {
+				if (!bidirectional)
+					return controller.getNextStep();
+
+				int side = turn++ % std::min(3, std::max(2, jobs));
+				if (side == 0)
+					return controller.takeLowest();
+				if (side == 1)
+					return controller.takeHighest();
+
+				return controller.getNextStep();
+			},
+			[&controller](int step) { return controller.isStepNeeded(step); },
+			[&controller, &founds](int core, ChildResult& result) {
+				handle_binary_result(&controller, &founds, core, result);
+				report_bounds(&controller, core);
+				plan_deadline(&controller, core);
+			});
+
+	stop_watchdog(watchdog);
+
+	report_best_solution(founds);
+	report_unresolved(controller.getUnresolved());
+	report_gap(&controller);
+}
+
+void execute_binary_search(int hmin, int hmax) {
+	std::vector<int> founds;
+
+	ParallelController controller(hmin, hmax);
+	configure_controller(&controller, &founds, hmin, hmax);
+
+	std::thread watchdog = start_watchdog(&controller);
+	HedgeTracker hedges(2.0);
+
+	//spare workers keep more steps in flight than there are slots, so that a
+	//valuable step can suspend a speculative one instead of waiting for it.
+	int workers = jobs + preemptSpare;
+	if (preemptSpare > 0)
+		supervisor.setPreemption(jobs, [&controller](int step) { return controller.getStepValue(step); });
+
+#pragma omp parallel for num_threads(workers)
+	for (int thread = 0; thread < workers; thread++) {
+		int turn = 0;
+
+		while (true) {
+			int step = 0;
+			std::string flags;
+			int weight = 0;
+			int cpus = 0;
+			bool wide = false;
+			//taken before asking for a step, so that a result set in between still wakes us below.
+			long seen = hedges.getVersion();
+
+			//bidirectional: worker 0 scans up from hmin, worker 1 down from hmax and
+			//the others bisect the interior; every result narrows the shared bracket
+			//for all of them. A lone worker alternates between the two ends.
+			int side = workers == 1 ? turn++ % 2 : thread;
+			if (!bidirectional || side > 1)
+				step = controller.getNextStep();
+			else if (side == 0)
+				step = controller.takeLowest();
+			else
+				step = controller.takeHighest();
+
+			if (step == 0) {
+				if ((hedgeSolver.empty() && allocation == "none") || !hedges.isRunning())
+					break;
+
+				//nothing useful left to start: run a straggler again with the other solver.
+				double elapsed = 0;
+				std::function<double(int)> predict;
+				if (!hedgeSolver.empty()) {
+					predict = [](int step) { return runtimeModel.getSamples() > 0 ? runtimeModel.predict(step) : 0; };
+					step = hedges.pick(predict, elapsed);
+				}
+
+				if (step != 0) {
+					flags = hedgeSolver;
+					//a hedge copy is speculative: the original keeps the larger CPU share.
+					weight = 50;
+					hedges.started(step);
+
+					std::ostringstream text;
+					text.precision(2);
+					text << "Hedge Step " << step << " with " << hedgeSolver << " after " << elapsed << "s";
+					writeLog(thread, text.str());
+				} else if (allocation != "none" && hedges.getCoresInUse() < jobs) {
+					//or hand the idle cores to the step in flight that is worth the most per core.
+					int idle = jobs - hedges.getCoresInUse();
+					int copy = 0;
+					//a needed step keeps some value even where the controller rates it 0.
+					auto value = [&controller](int step) {
+						return controller.isStepNeeded(step) ? 1 + controller.getStepValue(step) : 0;
+					};
+
+					if (allocation == "portfolio") {
+						step = hedges.widen(value, portfolioSolvers.size(), 1, copy);
+						if (step != 0)
+							flags = portfolioSolvers[copy - 1];
+					} else {
+						step = hedges.widen(value, 1, idle + 1, copy);
+						if (step != 0) {
+							cpus = idle + 1;
+							weight = 100 * cpus;
+							wide = true;
+							flags = threadFlags;
+							for (size_t pos = flags.find("{n}"); pos != std::string::npos; pos = flags.find("{n}"))
+								flags.replace(pos, 3, std::to_string(cpus));
+						}
+					}
+
+					//the supervisor only re-checks isNeeded when woken: a restarted step's
+					//single-threaded copy must give up its CPU and memory now.
+					if (step != 0) {
+						writeLog(thread, "Widen Step " + std::to_string(step) + " with " + flags);
+						supervisor.notify();
+					}
+				}
+
+				//until a copy finishes, a result is set or a flight starts to straggle.
+				if (step == 0) {
+					hedges.wait(seen, predict);
+					continue;
+				}
+			} else {
+				hedges.started(step);
 			}
+
+			//the first copy of a step to finish kills the others; a multi-threaded
+			//restart also replaces the single-threaded copy it was widened from.
+			ChildResult result = execute_step(thread, step, [&controller, &hedges, step, wide] {
+				return controller.isStepNeeded(step) && !hedges.isDone(step)
+						&& (wide || allocation != "threads" || !hedges.isWidened(step));
+			}, flags, weight, cpus);
+
+			bool first = hedges.finished(step, result.wallSeconds, is_decisive(result), std::max(1, cpus));
+
+			//another copy of the step is still running and may yet decide it.
+			if (!is_decisive(result) && hedges.isFlying(step))
+				continue;
+
+			if (result.aborted)
+				writeLog(thread, "Abort Step " + std::to_string(step));
+			else if (!first && (is_decisive(result) || hedges.isDone(step)))
+				continue;
+			else if (!hedgeSolver.empty() || allocation != "none")
+				supervisor.notify();
+
+			handle_binary_result(&controller, &founds, thread, result);
+			report_bounds(&controller, thread);
+			plan_deadline(&controller, thread);
+			hedges.notify();
 		}
+	}
 
-		if(order == ASC) {
-			current = current + (cores - 2) + 1;
-			target = current + (cores - 2);
+	stop_watchdog(watchdog);
+	supervisor.setPreemption(0, nullptr);
 
-			if(target > hmax)
-				target = hmax;
-		} else {
-			current = current - (cores - 2) - 1;
-			target = current - (cores - 2);
+	report_best_solution(founds);
+	report_unresolved(controller.getUnresolved());
+	report_gap(&controller);
+}
+
+//The unresolved steps that the confirmed bound has not made irrelevant.
+std::vector<int> unresolved_steps(StepDispenser* dispenser, int hmin) {
+	std::vector<int> steps;
+
+	for (int step : unresolvedSteps)
+		if (dispenser->isNeeded(domain_index(hmin, step)))
+			steps.push_back(step);
+
+	return steps;
+}
+
+//ASC stops at the first failing step, DESC at the first successful one.
+void handle_sequential_opt_result(StepDispenser* dispenser, std::vector<int>* founds, int core, int index,
+		ChildResult& result, Order order) {
+	int step = result.step;
+
+	if (result.aborted)
+		return;
+
+	bool qualifying = false;
+
+	if (result.verdict == VERDICT_FAILED) {
+		qualifying = order == ASC;
+
+		record_witness(core, result);
+#pragma omp critical(founds)
+		founds->push_back(step);
+		writeLog(core, "Finished Step " + std::to_string(step) + " > False");
+	} else if (result.verdict == VERDICT_SUCCESSFUL) {
+		qualifying = order == DESC;
+
+		writeLog(core, "Finished Step " + std::to_string(step) + " > True");
+	} else {
+#pragma omp critical(unresolved)
+		unresolvedSteps.insert(step);
+		writeLog(core, "Finished Step " + std::to_string(step) + " > " + describe_verdict(result));
+	}
+
+	//kill whatever is now past the confirmed step.
+	if (qualifying && dispenser->confirm(index))
+		supervisor.notify();
+}
+
+void execute_sequential_opt_search(int hmin, int hmax, Order order) {
+	std::vector<int> founds;
+	StepDispenser dispenser(domain_size(hmin, hmax), order == DESC);
+
+#pragma omp parallel for num_threads(jobs)
+	for (int thread = 0; thread < jobs; thread++) {
+
+		while (true) {
+			int index = dispenser.next();
+			if (index < 0)
+				break;
+
+			int step = domain_step(hmin, index);
 
-			if(target < hmin)
-				target = hmin;
+			ChildResult result = execute_step(thread, step, [&dispenser, index] { return dispenser.isNeeded(index); });
+
+			if (result.aborted)
+				writeLog(thread, "Abort Step " + std::to_string(step));
+
+			handle_sequential_opt_result(&dispenser, &founds, thread, index, result, order);
 		}
+	}
 
-		if (founds.size() > 0 ){
-			time_t end = std::time(NULL);
-			long time = end - start;
+	report_best_solution(founds);
+	report_unresolved(unresolved_steps(&dispenser, hmin));
+}
 
-			int result = 0;
-			if(order == ASC)
-				result = *std::min_element(founds.begin(), founds.end());
-			else {
-				result = *std::max_element(founds.begin(), founds.end());
-				result++;
-			}
+void execute_sequential_opt_search_reactor(int hmin, int hmax, Order order) {
+	std::vector<int> founds;
+	StepDispenser dispenser(domain_size(hmin, hmax), order == DESC);
+
+	run_reactor([&] {
+				int index = dispenser.next();
+				return index < 0 ? 0 : domain_step(hmin, index);
+			},
+			[&](int step) { return dispenser.isNeeded(domain_index(hmin, step)); },
+			[&](int core, ChildResult& result) {
+				handle_sequential_opt_result(&dispenser, &founds, core, domain_index(hmin, result.step), result, order);
+			});
+
+	report_best_solution(founds);
+	report_unresolved(unresolved_steps(&dispenser, hmin));
+}
 
-			std::cout << std::endl;
-			std::cout << "The best solution is: " << std::to_string(result) << " in " << time << "s" << std::endl;
+//Sliding window: a worker takes the next step as soon as it is free. ASC
+//stops at the first failing step, DESC at the first successful one; steps
+//past a confirmed one are killed, steps before it still have to finish.
+void execute_sequential_search_worker(StepDispenser* dispenser, int thread, int hmin, Order order) {
+	while (true) {
+		int index = dispenser->next();
+		if (index < 0)
 			break;
+
+		int step = domain_step(hmin, index);
+
+		ChildResult result = execute_step(thread, step, [dispenser, index] { return dispenser->isNeeded(index); });
+
+		if (result.aborted) {
+			writeLog(thread, "Abort Step " + std::to_string(step));
+			continue;
+		}
+
+		bool qualifying = false;
+
+		if ( result.verdict == VERDICT_FAILED ){
+			record_witness(thread, result);
+			qualifying = order == ASC;
+
+			writeLog(thread, "Finished Step " + std::to_string(step) + " > False");
+		} else if (result.verdict == VERDICT_SUCCESSFUL) {
+			qualifying = order == DESC;
+
+			writeLog(thread, "Finished Step " + std::to_string(step) + " > True");
+		} else {
+#pragma omp critical(unresolved)
+			unresolvedSteps.insert(step);
+			writeLog(thread, "Finished Step " + std::to_string(step) + " > " + describe_verdict(result));
 		}
 
-	}while(target <= hmax && target >= hmin && current <= hmax && current >= hmin);
+		if (qualifying && dispenser->confirm(index))
+			supervisor.notify();
+	}
+}
+
+void execute_sequential_search(int hmin, int hmax, Order order) {
+	StepDispenser dispenser(domain_size(hmin, hmax), order == DESC);
+
+#pragma omp parallel for num_threads(jobs)
+	for (int thread = 0; thread < jobs; thread++) {
+		execute_sequential_search_worker(&dispenser, thread, hmin, order);
+	}
+
+	if (dispenser.hasBound()) {
+		time_t end = std::time(NULL);
+		long time = end - start;
+
+		int result = domain_step(hmin, dispenser.getBound());
+
+		//DESC confirms the last true step: the answer is the next value worth asking about.
+		if (order == DESC) {
+			auto next = std::upper_bound(domain.begin(), domain.end(), result);
+			if (filtered && next != domain.end())
+				result = *next;
+			else
+				result++;
+		}
 
-	if (founds.size() == 0 ){
+		std::cout << std::endl;
+		std::cout << "The best solution is: " << std::to_string(result) << " in " << time << "s" << std::endl;
+	} else {
 		std::cout << std::endl;
 		std::cout << "Not found a solution :(" << std::endl;
 	}
+
+	report_unresolved(unresolved_steps(&dispenser, hmin));
+}
+
+//--method=auto: picks a method (and split) from the number of candidate steps,
+//the model size, the jobs and the cached history; every reason is logged.
+std::string choose_method(int hmin, int hmax, Order& order, bool needsController, std::vector<std::string>& reasons) {
+	int count = domain_size(hmin, hmax);
+	int nodes = benchmark.getNodes();
+	int edges = benchmark.getEdges();
+	bool largeModel = (long long) nodes * edges >= 10000;
+
+	std::vector<ChildResult> history = cache.getResults();
+	int timed = 0;
+	for (auto &result : history)
+		if (result.wallSeconds > 0)
+			timed++;
+
+	reasons.push_back(std::to_string(count) + " candidate steps, " + std::to_string(nodes) + " nodes x "
+			+ std::to_string(edges) + " edges, " + std::to_string(jobs) + " jobs, " + std::to_string(history.size())
+			+ " cached steps");
+
+	if (gallopHint != 0) {
+		order = ASC;
+		reasons.push_back("a hint was given: gallop up from it");
+		return "gallop";
+	}
+
+	if (!needsController) {
+		if (count <= jobs) {
+			order = ASC;
+			reasons.push_back("every step fits in one round: sequential_opt runs them all at once");
+			return "sequential_opt";
+		}
+
+		if (!monotoneQuery) {
+			order = ASC;
+			reasons.push_back("exact query: a true step only rules out itself, so scan up to the first failing step");
+			return "sequential_opt";
+		}
+
+		if (count <= 4 * jobs) {
+			order = ASC;
+			reasons.push_back("at most 4 rounds: sequential_opt, whose steps far below the optimum are cheap");
+			return "sequential_opt";
+		}
+	}
+
+	reasons.push_back("binary: O(log n) rounds over " + std::to_string(count) + " steps");
+
+	if (karySplit || costSelect)
+		return "binary";
+
+	if (timed >= 3) {
+		costSelect = true;
+		reasons.push_back(std::to_string(timed) + " timed steps in the cache: cost-aware selection");
+	} else if (jobs >= 3 || (jobs == 2 && largeModel)) {
+		karySplit = true;
+
+		std::ostringstream text;
+		text.precision(2);
+		text << "k-ary split: ~" << log(count) / log(jobs + 1.0) << " rounds instead of ~" << log(count) / log(2.0)
+				<< (largeModel ? ", and a large model makes every round slow" : "");
+		reasons.push_back(text.str());
+	}
+
+	return "binary";
 }
 
 void print_help_and_exit() {
 	std::cout << "Wrong parameters" << std::endl;
 	std::cout << "Usage:" << std::endl;
-	std::cout << "./ESBMCParallel filename.c hmin hmax --method=(sequential|sequential_opt|binary) [--order=(asc|desc)]" << std::endl;
+	std::cout << "./ESBMCParallel filename.c hmin hmax --method=(auto|sequential|sequential_opt|binary|gallop|bidirectional) [--order=(asc|desc)] [--hint=N] [--jobs=N] [--reactor] [--split=(bisect|kary)] [--select=(median|cost)] [--anytime] [--gap=(N|N%)] [--deadline=seconds] [--hedge=solver] [--timeout=soft[,hard]] [--retry=(xF|solver|jobs=N)[,...]] [--preempt=N] [--alloc=(auto|none|portfolio|threads)] [--portfolio=solver[,...]] [--solver-threads=\"flags with {n}\"] [--history=(file|none)] [--governor=(psi|none)] [--pin=(auto|none)] [--cgroup=(auto|none|path)] [--memory=(auto|none|size)] [--query=(auto|exact|monotone)] [--filter=(reachable|none)] [--cache=(file|none)] [--on-verdict=(wait|kill)] [--keep=(tail|trace)]" << std::endl;
 	exit(1);
 }
 
@@ -394,36 +1129,339 @@ int main(int argc, char *argv[]) {
 		print_help_and_exit();
 	}
 
-	std::string method = arguments.at(4);
-	method.erase(0, 9);
+	std::string method;
+	Order orderEnum = ASC;
+	bool reactor = false;
+	bool killOnVerdict = false;
+	bool traceOnly = false;
+	std::string query = "auto";
+	bool filter = true;
+	bool pin = true;
+	bool governed = false;
+	std::string cachePath = ".esbmc-parallel.cache";
+	std::string historyPath = ".esbmc-parallel.history";
+	bool allocGiven = false;
+	std::string cgroupPath = "auto";
+	std::string memory = "auto";
+	double softTimeout = 0;
+	double hardTimeout = 0;
+	std::string retry;
+
+	for (size_t i = 4; i < arguments.size(); i++) {
+		std::string argument = arguments.at(i);
+
+		if (argument.find("--method=") == 0) {
+			method = argument.substr(9);
+		} else if (argument.find("--order=") == 0) {
+			std::string order = argument.substr(8);
+
+			if(order != "asc" && order != "desc") {
+				std::cout << "Invalid Order: " << order << std::endl;
+				print_help_and_exit();
+			}
+
+			if(order == "desc")
+				orderEnum = DESC;
+		} else if (argument.find("--jobs=") == 0) {
+			jobs = std::atoi(argument.substr(7).c_str());
+
+			if (jobs < 1) {
+				std::cout << "Invalid Jobs: " << argument.substr(7) << std::endl;
+				print_help_and_exit();
+			}
+		} else if (argument == "--reactor") {
+			reactor = true;
+		} else if (argument.find("--on-verdict=") == 0) {
+			std::string onVerdict = argument.substr(13);
+
+			if (onVerdict != "wait" && onVerdict != "kill") {
+				std::cout << "Invalid On Verdict: " << onVerdict << std::endl;
+				print_help_and_exit();
+			}
+
+			killOnVerdict = onVerdict == "kill";
+		} else if (argument.find("--query=") == 0) {
+			query = argument.substr(8);
+
+			if (query != "auto" && query != "exact" && query != "monotone") {
+				std::cout << "Invalid Query: " << query << std::endl;
+				print_help_and_exit();
+			}
+		} else if (argument.find("--filter=") == 0) {
+			std::string filterName = argument.substr(9);
+
+			if (filterName != "reachable" && filterName != "none") {
+				std::cout << "Invalid Filter: " << filterName << std::endl;
+				print_help_and_exit();
+			}
+
+			filter = filterName == "reachable";
+		} else if (argument.find("--cache=") == 0) {
+			cachePath = argument.substr(8);
+
+			if (cachePath.empty()) {
+				std::cout << "Invalid Cache: " << cachePath << std::endl;
+				print_help_and_exit();
+			}
+		} else if (argument.find("--split=") == 0) {
+			std::string split = argument.substr(8);
+
+			if (split != "bisect" && split != "kary") {
+				std::cout << "Invalid Split: " << split << std::endl;
+				print_help_and_exit();
+			}
+
+			karySplit = split == "kary";
+		} else if (argument.find("--hint=") == 0) {
+			gallopHint = std::atoi(argument.substr(7).c_str());
+
+			if (gallopHint < 1) {
+				std::cout << "Invalid Hint: " << argument.substr(7) << std::endl;
+				print_help_and_exit();
+			}
+		} else if (argument == "--anytime") {
+			anytime = true;
+		} else if (argument.find("--gap=") == 0) {
+			std::string gap = argument.substr(6);
+
+			gapPercent = !gap.empty() && gap[gap.size() - 1] == '%';
+			gapLimit = std::atof(gap.c_str());
+			anytime = true;
+
+			if (gap.empty() || gapLimit < 0 || (gapLimit == 0 && gap[0] != '0')) {
+				std::cout << "Invalid Gap: " << gap << std::endl;
+				print_help_and_exit();
+			}
+		} else if (argument.find("--deadline=") == 0) {
+			deadline = std::atoi(argument.substr(11).c_str());
+			anytime = true;
+
+			if (deadline < 1) {
+				std::cout << "Invalid Deadline: " << argument.substr(11) << std::endl;
+				print_help_and_exit();
+			}
+		} else if (argument.find("--alloc=") == 0) {
+			allocation = argument.substr(8);
+
+			if (allocation != "none" && allocation != "portfolio" && allocation != "threads" && allocation != "auto") {
+				std::cout << "Invalid Alloc: " << allocation << std::endl;
+				print_help_and_exit();
+			}
+
+			allocGiven = true;
+		} else if (argument.find("--portfolio=") == 0) {
+			std::istringstream solvers(argument.substr(12));
+			std::string solver;
+
+			portfolioSolvers.clear();
+			while (std::getline(solvers, solver, ',')) {
+				if (solver.find("--") != 0)
+					solver = "--" + solver;
+
+				if (!is_solver_flag(solver)) {
+					std::cout << "Invalid Portfolio: " << argument.substr(12) << std::endl;
+					print_help_and_exit();
+				}
+
+				portfolioSolvers.push_back(solver);
+			}
+
+			if (portfolioSolvers.empty()) {
+				std::cout << "Invalid Portfolio: " << argument.substr(12) << std::endl;
+				print_help_and_exit();
+			}
+		} else if (argument.find("--solver-threads=") == 0) {
+			threadFlags = argument.substr(17);
+
+			if (threadFlags.find("{n}") == std::string::npos) {
+				std::cout << "Invalid Solver Threads: " << threadFlags << std::endl;
+				print_help_and_exit();
+			}
+		} else if (argument.find("--history=") == 0) {
+			historyPath = argument.substr(10);
+
+			if (historyPath.empty()) {
+				std::cout << "Invalid History: " << historyPath << std::endl;
+				print_help_and_exit();
+			}
+		} else if (argument.find("--preempt=") == 0) {
+			preemptSpare = std::atoi(argument.substr(10).c_str());
+
+			if (preemptSpare < 1) {
+				std::cout << "Invalid Preempt: " << argument.substr(10) << std::endl;
+				print_help_and_exit();
+			}
+		} else if (argument.find("--governor=") == 0) {
+			std::string governorName = argument.substr(11);
+
+			if (governorName != "psi" && governorName != "none") {
+				std::cout << "Invalid Governor: " << governorName << std::endl;
+				print_help_and_exit();
+			}
+
+			governed = governorName == "psi";
+		} else if (argument.find("--pin=") == 0) {
+			std::string pinName = argument.substr(6);
+
+			if (pinName != "auto" && pinName != "none") {
+				std::cout << "Invalid Pin: " << pinName << std::endl;
+				print_help_and_exit();
+			}
+
+			pin = pinName == "auto";
+		} else if (argument.find("--cgroup=") == 0) {
+			cgroupPath = argument.substr(9);
+
+			if (cgroupPath != "auto" && cgroupPath != "none" && cgroupPath.find('/') != 0) {
+				std::cout << "Invalid Cgroup: " << cgroupPath << std::endl;
+				print_help_and_exit();
+			}
+		} else if (argument.find("--memory=") == 0) {
+			memory = argument.substr(9);
+
+			if (memory != "auto" && memory != "none" && parse_memory_kb(memory) < 0) {
+				std::cout << "Invalid Memory: " << memory << std::endl;
+				print_help_and_exit();
+			}
+		} else if (argument.find("--timeout=") == 0) {
+			std::string timeout = argument.substr(10);
+			size_t comma = timeout.find(',');
+
+			//the hard timeout defaults to a short grace period after the soft one.
+			softTimeout = std::atof(timeout.c_str());
+			hardTimeout = comma == std::string::npos ? softTimeout + 5 : std::atof(timeout.c_str() + comma + 1);
+
+			if (softTimeout <= 0 || hardTimeout < softTimeout) {
+				std::cout << "Invalid Timeout: " << timeout << std::endl;
+				print_help_and_exit();
+			}
+		} else if (argument.find("--retry=") == 0) {
+			retry = argument.substr(8);
+
+			if (!retryLadder.parse(retry)) {
+				std::cout << "Invalid Retry: " << retry << std::endl;
+				print_help_and_exit();
+			}
+		} else if (argument.find("--hedge=") == 0) {
+			std::string solver = argument.substr(8);
+
+			if (solver.find("--") != 0)
+				solver = "--" + solver;
+
+			if (!is_solver_flag(solver)) {
+				std::cout << "Invalid Hedge: " << argument.substr(8) << std::endl;
+				print_help_and_exit();
+			}
 
-	if(method != "binary" && method != "sequential" && method != "sequential_opt") {
+			hedgeSolver = solver;
+		} else if (argument.find("--select=") == 0) {
+			std::string select = argument.substr(9);
+
+			if (select != "median" && select != "cost") {
+				std::cout << "Invalid Select: " << select << std::endl;
+				print_help_and_exit();
+			}
+
+			costSelect = select == "cost";
+		} else if (argument.find("--keep=") == 0) {
+			std::string keep = argument.substr(7);
+
+			if (keep != "tail" && keep != "trace") {
+				std::cout << "Invalid Keep: " << keep << std::endl;
+				print_help_and_exit();
+			}
+
+			traceOnly = keep == "trace";
+		} else {
+			std::cout << "Invalid Option: " << argument << std::endl;
+			print_help_and_exit();
+		}
+	}
+
+	if(method != "binary" && method != "sequential" && method != "sequential_opt" && method != "gallop"
+			&& method != "bidirectional" && method != "auto") {
 		std::cout << "Invalid Method: " << method << std::endl;
 		print_help_and_exit();
 	}
 
-	Order orderEnum = ASC;
+	if (anytime && (method == "sequential" || method == "sequential_opt")) {
+		std::cout << "--anytime, --gap and --deadline need a controller-based method" << std::endl;
+		print_help_and_exit();
+	}
 
-	if (arguments.size() >= 6) {
-		std::string order = arguments.at(5);
-		order.erase(0, 8);
+	if (!hedgeSolver.empty() && reactor) {
+		std::cout << "--hedge is not supported in reactor mode" << std::endl;
+		print_help_and_exit();
+	}
 
-		if(order != "asc" && order != "desc") {
-			std::cout << "Invalid Order: " << order << std::endl;
-			print_help_and_exit();
-		}
+	//without an explicit choice, giving a portfolio or a thread template lets the history decide.
+	if (!allocGiven && (!portfolioSolvers.empty() || !threadFlags.empty()))
+		allocation = "auto";
 
-		if(order == "desc")
-			orderEnum = DESC;
+	if ((allocation == "portfolio" && portfolioSolvers.empty()) || (allocation == "threads" && threadFlags.empty())
+			|| (allocation == "auto" && portfolioSolvers.empty() && threadFlags.empty())) {
+		std::cout << "--alloc=" << allocation << " needs --portfolio or --solver-threads" << std::endl;
+		print_help_and_exit();
 	}
 
+	if (allocation != "none" && (reactor || method == "sequential" || method == "sequential_opt")) {
+		std::cout << "--alloc needs a controller-based method outside reactor mode" << std::endl;
+		print_help_and_exit();
+	}
+
+	if (preemptSpare > 0 && (reactor || method == "sequential" || method == "sequential_opt")) {
+		std::cout << "--preempt needs a controller-based method outside reactor mode" << std::endl;
+		print_help_and_exit();
+	}
+
+	if (karySplit && costSelect) {
+		std::cout << "--split=kary and --select=cost cannot be combined" << std::endl;
+		print_help_and_exit();
+	}
+
+	if (reactor && method == "sequential") {
+		std::cout << "Reactor mode supports binary and sequential_opt only" << std::endl;
+		print_help_and_exit();
+	}
+
+	retryLadder.setTimeouts(softTimeout, hardTimeout);
+
 	start = std::time(NULL);
+	deadlineAt = std::chrono::steady_clock::now() + std::chrono::seconds(deadline);
 
 	filename = arguments.at(1);
 
 	int hmin = std::atoi(arguments.at(2).c_str());
 	int hmax = std::atoi(arguments.at(3).c_str());
 
+	if (gallopHint != 0 && ((method != "gallop" && method != "auto") || gallopHint < hmin || gallopHint > hmax)) {
+		std::cout << "--hint needs --method=gallop (or auto) and a value in [hmin, hmax]" << std::endl;
+		print_help_and_exit();
+	}
+
+	if (benchmark.load(filename))
+		supervisor.setWitness("x", benchmark.getNodes());
+
+	bool monotoneModel = benchmark.getQueryForm() == QUERY_MONOTONE || benchmark.hasMonotoneSwitch();
+
+	if (query == "auto")
+		query = monotoneModel ? "monotone" : "exact";
+
+	//the model would still answer fobj == k, and monotone pruning would then
+	//rule out values that no step has.
+	if (query == "monotone" && !monotoneModel) {
+		std::cout << "Invalid Query: monotone, the model has neither the fobj <= k form nor the MONOTONE_QUERY switch"
+				<< std::endl;
+		print_help_and_exit();
+	}
+
+	monotoneQuery = query == "monotone";
+	monotoneMacro = monotoneQuery && benchmark.getQueryForm() != QUERY_MONOTONE && benchmark.hasMonotoneSwitch();
+
+	//the optimum is always a reachable sum, whichever query form is used.
+	if (filter)
+		filtered = benchmark.getReachableObjectives(hmin, hmax, domain);
+
 	std::string esbmc_version = execute_cmd(executable + " --version");
 	size_t nl_version = esbmc_version.find("\n");
 	esbmc_version.replace(nl_version, std::string("\n").length(), "");
@@ -436,10 +1474,87 @@ int main(int argc, char *argv[]) {
 	size_t nl_hw = hardware.find("\n");
 	hardware.replace(nl_hw, std::string("\n").length(), "");
 
-	std::string core_number = execute_cmd("echo \"$(cat /proc/cpuinfo | grep processor | wc -l)\"");
-	size_t nl_cn = core_number.find("\n");
-	core_number.replace(nl_cn, std::string("\n").length(), "");
-	int cores = std::atoi(core_number.c_str());
+	//the CPUs we may actually use, which a cpuset or taskset can restrict.
+	int cores = topology.load() ? topology.getCpus() : sysconf(_SC_NPROCESSORS_ONLN);
+
+	bool jobsGiven = jobs > 0;
+	if (jobs == 0)
+		jobs = std::max(1, cores - 1);
+
+	//governed, jobs is only the ceiling; by default it leaves room to use every CPU.
+	int governedJobs = jobs;
+	if (governed && !jobsGiven)
+		jobs = std::max(jobs, cores);
+
+	LoadGovernor governor(governedJobs, jobs, cores);
+
+	std::ifstream model(filename);
+	std::stringstream source;
+	source << model.rdbuf();
+
+	std::string key = source.str() + "\n" + esbmc_version + "\n" + esbmc_parameters;
+	if (monotoneMacro)
+		key += " -DMONOTONE_QUERY";
+
+	if (cachePath != "none")
+		cache.open(cachePath, StepCache::hash(key));
+
+	//the same benchmark under the same flags: only the core split differs between runs.
+	std::vector<std::string> splits;
+	if (!portfolioSolvers.empty() || !threadFlags.empty()) {
+		splits.push_back("none");
+		if (!portfolioSolvers.empty())
+			splits.push_back("portfolio");
+		if (!threadFlags.empty())
+			splits.push_back("threads");
+
+		if (historyPath != "none")
+			runHistory.open(historyPath, StepCache::hash(key));
+	}
+
+	//a delegated cgroup is optional: without one, admission falls back to each child's RSS.
+	if (cgroupPath != "none" && !cgroups.open(cgroupPath == "auto" ? "" : cgroupPath) && cgroupPath != "auto") {
+		std::cout << "Invalid Cgroup: " << cgroups.getError() << std::endl;
+		print_help_and_exit();
+	}
+
+	long memoryBudget = 0;
+	if (memory == "auto") {
+		memoryBudget = available_memory_kb();
+		if (cgroups.isOpen() && cgroups.getLimitKb() > 0)
+			memoryBudget = std::min(memoryBudget, cgroups.getLimitKb());
+		memoryBudget = memoryBudget * 0.9;
+	} else if (memory != "none") {
+		memoryBudget = parse_memory_kb(memory);
+	}
+
+	memoryModel.setRange(hmin, hmax);
+	for (auto &result : cache.getResults())
+		if (result.maxRssKb > 0)
+			memoryModel.observe(result.step, result.maxRssKb);
+
+	std::vector<std::string> reasons;
+	if (method == "auto")
+		method = choose_method(hmin, hmax, orderEnum, anytime || reactor, reasons);
+
+	//gallop is the binary search with a different opening.
+	gallopSearch = method == "gallop";
+	gallopDown = orderEnum == DESC;
+	bidirectional = method == "bidirectional";
+
+	bool controlled = method == "binary" || method == "gallop" || method == "bidirectional";
+	bool allocAuto = allocation == "auto" && controlled;
+
+	if (!controlled)
+		allocation = "none";
+	else if (allocAuto)
+		allocation = runHistory.best(splits, jobs);
+
+	//the first run of a split is its measurement: the cache's verdicts would
+	//shorten it by however much earlier runs happened to leave behind.
+	bool measuring = allocAuto && runHistory.isOpen() && runHistory.getRuns(allocation, jobs) == 0;
+	if (measuring)
+		cache.setLookups(false);
 
 	std::cout << std::endl;
 	std::cout << "*** ESBMC Parallel Runner v2.0 ***" << std::endl;
@@ -448,19 +1563,143 @@ int main(int argc, char *argv[]) {
 	std::cout << "Hardware: " << hardware << std::endl << std::endl;
 	std::cout << "Log Format: [time(s)] > C[core]: [log string]" << std::endl;
 	std::cout << "File: " << basename(filename.c_str()) << std::endl;
-	std::cout << "Method: " << method.c_str() << std::endl;
+	std::cout << "Method: " << method.c_str() << (reasons.empty() ? "" : " (auto)") << std::endl;
+
+	for (auto &reason : reasons)
+		std::cout << "Auto: " << reason << std::endl;
+
+	if (benchmark.isLoaded())
+		std::cout << "Model: " << benchmark.getNodes() << " nodes, " << benchmark.getEdges() << " edges" << std::endl;
 
 	if(orderEnum == ASC)
 		std::cout << "Order: Asc" << std::endl;
 	else
 		std::cout << "Order: Desc" << std::endl;
 
+	if (monotoneQuery)
+		std::cout << "Query: monotone (fobj <= k)" << std::endl;
+	else
+		std::cout << "Query: exact (fobj == k)" << std::endl;
+
+	if (method == "binary" || method == "gallop" || method == "bidirectional")
+		std::cout << "Split: " << (karySplit ? "k-ary" : (costSelect ? "cost-aware" : "bisect")) << std::endl;
+
+	if (filtered)
+		std::cout << "Steps: " << domain.size() << " reachable of " << std::max(0, hmax - hmin + 1) << std::endl;
+
+	if (cache.isOpen())
+		std::cout << "Cache: " << cachePath << " (" << cache.getSteps().size() << " known steps)" << std::endl;
+
+	std::cout << "Jobs: " << jobs << (reactor ? " (reactor)" : "") << std::endl;
+
+	if (allocation != "none" || allocAuto) {
+		std::vector<std::string> notes;
+		if (allocAuto)
+			notes.push_back("auto");
+
+		if (runHistory.getRuns(allocation, jobs) > 0) {
+			std::ostringstream mean;
+			mean << "mean " << runHistory.getMean(allocation, jobs) << "s over " << runHistory.getRuns(allocation, jobs)
+					<< " runs";
+			notes.push_back(mean.str());
+		} else if (runHistory.isOpen()) {
+			notes.push_back(measuring ? "untried, measured without cache lookups" : "untried");
+		}
+
+		std::cout << "Alloc: " << allocation;
+		for (size_t i = 0; i < notes.size(); i++)
+			std::cout << (i == 0 ? " (" : ", ") << notes[i];
+		std::cout << (notes.empty() ? "" : ")") << std::endl;
+	}
+
+	if (preemptSpare > 0)
+		std::cout << "Preempt: " << preemptSpare << " speculative steps beyond the jobs" << std::endl;
+
+	if (governed)
+		std::cout << "Governor: psi" << (LoadGovernor::sample().pressure ? "" : " unavailable, loadavg only") << ", "
+				<< governedJobs << " of up to " << jobs << " steps" << std::endl;
+
+	if (topology.getCpus() > 0)
+		std::cout << "Topology: " << topology.getCpus() << " CPUs, " << topology.getCores() << " cores, "
+				<< topology.getNodes() << (topology.getNodes() == 1 ? " node" : " nodes")
+				<< (pin ? ", pinned" : "") << std::endl;
+
+	if (memoryBudget > 0)
+		std::cout << "Memory: " << memoryBudget / 1024 << " MB budget" << std::endl;
+
+	if (cgroups.isOpen())
+		std::cout << "Cgroups: " << cgroups.getPath() << std::endl;
+	else if (cgroupPath != "none")
+		std::cout << "Cgroups: unavailable, " << cgroups.getError() << std::endl;
+
+	if (softTimeout > 0)
+		std::cout << "Timeout: " << softTimeout << "s, hard " << hardTimeout << "s" << std::endl;
+
+	if (!retry.empty())
+		std::cout << "Retry: " << retry << std::endl;
+
 	std::cout << "RUNNING:" << std::endl;
 
-	if(method == "binary")
-		execute_binary_search(hmin, hmax, cores);
-	else if(method == "sequential")
-		execute_sequential_search(hmin, hmax, cores, orderEnum);
-	else
-		execute_sequential_opt_search(hmin, hmax, cores, orderEnum);
+	supervisor.setOutputPolicy(64 * 1024, traceOnly, killOnVerdict);
+	supervisor.setMemoryPolicy(&cgroups, memoryBudget);
+
+	if (pin && topology.getCpus() > 0)
+		supervisor.setPlacement(&topology);
+
+	//a lower limit pauses new steps until enough running ones have finished.
+	if (governed) {
+		supervisor.setRunningLimit(governor.getLimit());
+
+		governor.start([] { return supervisor.getRunning(); }, [](int previous, int limit, LoadSample& sample) {
+			supervisor.setRunningLimit(limit);
+
+			std::ostringstream text;
+			text.precision(3);
+			text << "Governor: " << previous << " -> " << limit << " steps (cpu " << sample.cpuSome << "%, memory "
+					<< sample.memorySome << "%, io " << sample.ioFull << "%, load " << sample.load << ")";
+			writeLog(0, text.str());
+		});
+	}
+
+	auto searchStart = std::chrono::steady_clock::now();
+
+	if (reactor) {
+		signal(SIGUSR1, on_jobs_signal);
+		signal(SIGUSR2, on_jobs_signal);
+
+		if(method == "binary" || method == "gallop" || method == "bidirectional")
+			execute_binary_search_reactor(hmin, hmax);
+		else
+			execute_sequential_opt_search_reactor(hmin, hmax, orderEnum);
+	} else {
+		supervisor.start();
+
+		if(method == "binary" || method == "gallop" || method == "bidirectional")
+			execute_binary_search(hmin, hmax);
+		else if(method == "sequential")
+			execute_sequential_search(hmin, hmax, orderEnum);
+		else
+			execute_sequential_opt_search(hmin, hmax, orderEnum);
+
+		supervisor.stop();
+	}
+
+	governor.stop();
+
+	//a run that started no step, or one cut short by --gap or --deadline, says nothing about the split.
+	if (runHistory.isOpen() && controlled && supervisor.getSpawnCount() > 0 && gapLimit < 0 && deadline == 0)
+		runHistory.record(allocation, jobs,
+				std::chrono::duration<double>(std::chrono::steady_clock::now() - searchStart).count());
+
+	if (cache.isOpen())
+		std::cout << "Cache: " << cache.getHits() << " hits, " << cache.getStored() << " new steps" << std::endl;
+
+	std::cout << "CPU time spent on aborted steps: " << supervisor.getAbortedCpuSeconds() << "s" << std::endl;
+
+	if (preemptSpare > 0)
+		std::cout << "Suspensions: " << supervisor.getSuspensions() << std::endl;
+
+	if (supervisor.getSpawnCount() > 0)
+		std::cout << "Spawn overhead: " << supervisor.getSpawnMilliseconds() / supervisor.getSpawnCount()
+				<< "ms per step over " << supervisor.getSpawnCount() << " steps" << std::endl;
 }
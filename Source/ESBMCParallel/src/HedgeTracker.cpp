@@ -0,0 +1,201 @@
+/*
+ * HedgeTracker.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "HedgeTracker.h"
+
+#include <algorithm>
+
+HedgeTracker::HedgeTracker(double factor) {
+	this->factor = factor;
+	this->version = 0;
+}
+
+HedgeTracker::~HedgeTracker() {
+
+}
+
+void HedgeTracker::started(int step, int cores) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto f = flights.find(step);
+
+	if (f == flights.end()) {
+		flights[step] = Flight { std::chrono::steady_clock::now(), 1, false, cores, 0 };
+	} else {
+		f->second.copies++;
+		f->second.cores += cores;
+	}
+}
+
+bool HedgeTracker::finished(int step, double seconds, bool decisive, int cores) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto f = flights.find(step);
+	if (f != flights.end()) {
+		f->second.cores -= cores;
+		if (--f->second.copies <= 0)
+			flights.erase(f);
+	}
+
+	version++;
+	changed.notify_all();
+
+	if (!decisive || done[step])
+		return false;
+
+	//the other copy is about to be killed, so the step no longer counts as running.
+	done[step] = true;
+	flights.erase(step);
+	durations.push_back(seconds);
+
+	return true;
+}
+
+bool HedgeTracker::isDone(int step) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto it = done.find(step);
+	return it != done.end() && it->second;
+}
+
+bool HedgeTracker::isRunning() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return !flights.empty();
+}
+
+bool HedgeTracker::isFlying(int step) {
+	std::lock_guard<std::mutex> lock(mutex);
+	return flights.count(step) > 0;
+}
+
+bool HedgeTracker::isWidened(int step) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto f = flights.find(step);
+	return f != flights.end() && f->second.widened > 0;
+}
+
+//Copies of a decided step are on their way out, but hold their cores until then.
+int HedgeTracker::getCoresInUse() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	int cores = 0;
+	for (auto &f : flights)
+		cores += f.second.cores;
+
+	return cores;
+}
+
+//The expected time is the larger of the model's prediction and the median
+//finished step, so that a single fast sample does not make everything a straggler.
+int HedgeTracker::pick(std::function<double(int)> predict, double& elapsed) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (durations.empty())
+		return 0;
+
+	double median = getMedian();
+	auto now = std::chrono::steady_clock::now();
+	int straggler = 0;
+	double worst = 0;
+
+	for (auto &f : flights) {
+		if (f.second.hedged)
+			continue;
+
+		double seconds = std::chrono::duration<double>(now - f.second.start).count();
+		double expected = std::max(median, predict ? predict(f.first) : 0);
+
+		if (seconds > factor * expected && seconds / expected > worst) {
+			worst = seconds / expected;
+			straggler = f.first;
+			elapsed = seconds;
+		}
+	}
+
+	if (straggler != 0)
+		flights[straggler].hedged = true;
+
+	return straggler;
+}
+
+long HedgeTracker::getVersion() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return version;
+}
+
+void HedgeTracker::notify() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	version++;
+	changed.notify_all();
+}
+
+//Nothing but time turns a flight into a straggler, so with hedging on the wait
+//also ends when the first unhedged flight passes its limit.
+void HedgeTracker::wait(long seen, std::function<double(int)> predict) {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	if (!predict || durations.empty()) {
+		changed.wait(lock, [this, seen] { return version != seen; });
+		return;
+	}
+
+	double median = getMedian();
+	auto until = std::chrono::steady_clock::time_point::max();
+
+	for (auto &f : flights) {
+		if (f.second.hedged)
+			continue;
+
+		double expected = std::max(median, predict(f.first));
+		auto limit = f.second.start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+				std::chrono::duration<double>(factor * expected));
+		until = std::min(until, limit);
+	}
+
+	if (until == std::chrono::steady_clock::time_point::max())
+		changed.wait(lock, [this, seen] { return version != seen; });
+	else
+		changed.wait_until(lock, until, [this, seen] { return version != seen; });
+}
+
+double HedgeTracker::getMedian() {
+	std::vector<double> sorted = durations;
+	std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+
+	return sorted[sorted.size() / 2];
+}
+
+//The copy is counted as started here, so that two idle workers cannot both
+//hand out the same cores.
+int HedgeTracker::widen(std::function<double(int)> value, int maxCopies, int cores, int& copy) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	int best = 0;
+	double most = 0;
+
+	for (auto &f : flights) {
+		if (f.second.widened >= maxCopies)
+			continue;
+
+		double perCore = value(f.first) / std::max(1, f.second.cores);
+		if (perCore > most) {
+			most = perCore;
+			best = f.first;
+		}
+	}
+
+	if (best == 0)
+		return 0;
+
+	Flight& flight = flights[best];
+	flight.copies++;
+	flight.cores += cores;
+	copy = ++flight.widened;
+
+	return best;
+}
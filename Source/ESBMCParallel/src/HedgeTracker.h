@@ -0,0 +1,67 @@
+/*
+ * HedgeTracker.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef HEDGETRACKER_H_
+#define HEDGETRACKER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+//Straggler detection for hedged steps: remembers when each step started and
+//how long finished steps took. A step running far longer than predicted (or
+//than the median finished step) may be run a second time; whichever copy
+//finishes first wins. It also counts the cores each copy holds, so that idle
+//cores can be handed to the steps still in flight.
+class HedgeTracker {
+public:
+	HedgeTracker(double factor);
+	virtual ~HedgeTracker();
+
+	void started(int step, int cores = 1);
+	//true for the first copy of a step to finish with a result (not aborted).
+	bool finished(int step, double seconds, bool decisive, int cores = 1);
+	bool isDone(int step);
+	bool isRunning();
+	bool isFlying(int step);
+	bool isWidened(int step);
+	int getCoresInUse();
+
+	//the straggler to hedge, or 0; each step is hedged at most once.
+	int pick(std::function<double(int)> predict, double& elapsed);
+	//the step with the most value per core held, given another copy on cores
+	//more; copy numbers its extra copies from 1, up to maxCopies. 0 if none.
+	int widen(std::function<double(int)> value, int maxCopies, int cores, int& copy);
+
+	//bumped whenever a copy finishes or notify() reports a step result.
+	long getVersion();
+	void notify();
+	//blocks until the version moves past seen, or (given predict) until a flight becomes a straggler.
+	void wait(long seen, std::function<double(int)> predict);
+private:
+	struct Flight {
+		std::chrono::steady_clock::time_point start;
+		int copies;
+		bool hedged;
+		int cores;
+		int widened;
+	};
+
+	double factor;
+	std::map<int, Flight> flights;
+	std::map<int, bool> done;
+	std::vector<double> durations;
+	long version;
+	std::condition_variable changed;
+	std::mutex mutex;
+
+	double getMedian();
+};
+
+#endif /* HEDGETRACKER_H_ */
@@ -0,0 +1,130 @@
+/*
+ * LoadGovernor.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "LoadGovernor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+//the avg10 value of the "some" or "full" line, -1 when PSI is not there.
+static double read_pressure(std::string resource, std::string kind) {
+	std::ifstream file("/proc/pressure/" + resource);
+	std::string line;
+
+	while (std::getline(file, line))
+		if (line.compare(0, kind.size() + 1, kind + " ") == 0) {
+			size_t avg = line.find("avg10=");
+			return avg == std::string::npos ? -1 : atof(line.c_str() + avg + 6);
+		}
+
+	return -1;
+}
+
+LoadGovernor::LoadGovernor(int initial, int ceiling, int cpus) {
+	this->ceiling = std::max(1, ceiling);
+	this->cpus = std::max(1, cpus);
+	this->limit = std::min(this->ceiling, std::max(1, initial));
+	this->active = false;
+}
+
+LoadGovernor::~LoadGovernor() {
+	stop();
+}
+
+void LoadGovernor::start(std::function<int()> running, std::function<void(int, int, LoadSample&)> changed) {
+	this->running = running;
+	this->changed = changed;
+
+	active = true;
+	thread = std::thread(&LoadGovernor::loop, this);
+}
+
+void LoadGovernor::stop() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!active)
+			return;
+
+		active = false;
+	}
+
+	wakeup.notify_all();
+	thread.join();
+}
+
+int LoadGovernor::getLimit() {
+	return limit;
+}
+
+LoadSample LoadGovernor::sample() {
+	LoadSample sample;
+
+	sample.cpuSome = read_pressure("cpu", "some");
+	sample.memorySome = read_pressure("memory", "some");
+	sample.ioFull = read_pressure("io", "full");
+	sample.pressure = sample.cpuSome >= 0;
+
+	sample.cpuSome = std::max(0.0, sample.cpuSome);
+	sample.memorySome = std::max(0.0, sample.memorySome);
+	sample.ioFull = std::max(0.0, sample.ioFull);
+
+	std::ifstream loadavg("/proc/loadavg");
+	if (!(loadavg >> sample.load))
+		sample.load = 0;
+
+	return sample;
+}
+
+//avg10 reacts within seconds but is smoothed over ten, so decisions are
+//spaced out to let each one show up in the next sample.
+void LoadGovernor::loop() {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (active) {
+		wakeup.wait_for(lock, std::chrono::seconds(5));
+		if (!active)
+			break;
+
+		LoadSample current = sample();
+		int previous = limit;
+		int next = adjust(current, running());
+
+		if (next == previous)
+			continue;
+
+		limit = next;
+
+		lock.unlock();
+		changed(previous, next, current);
+		lock.lock();
+	}
+}
+
+int LoadGovernor::adjust(LoadSample& sample, int running) {
+	int current = limit;
+
+	//the load average counts our own steps too; what is left is other tenants.
+	double external = std::max(0.0, sample.load - running);
+	int fits = std::max(1, (int) floor(cpus - external + 0.5));
+
+	bool pressured = sample.cpuSome > 40 || sample.memorySome > 10 || sample.ioFull > 20;
+	bool quiet = sample.cpuSome < 10 && sample.memorySome < 1 && sample.ioFull < 5;
+
+	if (pressured)
+		return std::max(1, current - std::max(1, current / 4));
+
+	if (fits < current)
+		return current - 1;
+
+	if (quiet && fits > current && current < ceiling)
+		return current + 1;
+
+	return current;
+}
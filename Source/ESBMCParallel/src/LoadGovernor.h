@@ -0,0 +1,55 @@
+/*
+ * LoadGovernor.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef LOADGOVERNOR_H_
+#define LOADGOVERNOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+//avg10 shares (percent) of time some task stalled on CPU or memory and all
+//tasks stalled on IO, from /proc/pressure, and the 1-minute load average.
+struct LoadSample {
+	bool pressure;
+	double cpuSome;
+	double memorySome;
+	double ioFull;
+	double load;
+};
+
+//Decides how many steps may run at once. Under pressure the limit drops by a
+//quarter; on a quiet host with CPUs left over by other tenants it grows back
+//by one, up to the ceiling. Steps already running are never touched.
+class LoadGovernor {
+public:
+	LoadGovernor(int initial, int ceiling, int cpus);
+	virtual ~LoadGovernor();
+
+	//running: our own steps in flight; changed: called with each new limit.
+	void start(std::function<int()> running, std::function<void(int, int, LoadSample&)> changed);
+	void stop();
+
+	int getLimit();
+	static LoadSample sample();
+private:
+	void loop();
+	int adjust(LoadSample& sample, int running);
+
+	int ceiling;
+	int cpus;
+	std::atomic<int> limit;
+	bool active;
+	std::function<int()> running;
+	std::function<void(int, int, LoadSample&)> changed;
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable wakeup;
+};
+
+#endif /* LOADGOVERNOR_H_ */
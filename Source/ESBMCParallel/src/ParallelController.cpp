@@ -9,13 +9,27 @@
 #include <cmath>
 #include <algorithm>
 #include <iostream>
-#include <set>
 
 ParallelController::ParallelController(int hmin, int hmax) {
 	this->hmin = hmin;
 	this->hmax = hmax;
+	this->monotone = true;
+	this->mapped = false;
+	this->workers = 0;
+	this->stopped = false;
+	this->feasible = false;
+	this->stoppedLower = 0;
+	this->galloping = false;
+	this->gallopDown = false;
+	this->gallopBase = 0;
+	this->gallopOffset = 0;
+	this->gallopLast = 0;
+	this->lowLast = 0;
+	this->lowStride = 1;
+	this->highLast = 0;
+	this->highStride = 1;
 
-	chunks.push_back(std::make_pair(hmin, hmax));
+	addChunk(hmin, hmax);
 }
 
 ParallelController::~ParallelController() {
@@ -23,59 +37,578 @@ ParallelController::~ParallelController() {
 }
 
 int ParallelController::getNextStep() {
-	int largestChunk = -1;
-	std::pair<int, int> largestChunkPair;
+	std::lock_guard<std::mutex> lock(mutex);
 
-	for(auto &c : chunks) {
-	    if(c.second -c.first > largestChunk) {
-	    	largestChunkPair = c;
-	    	largestChunk = c.second -c.first;
-	    }
+	if(stopped)
+		return 0;
+
+	return dispatch(nextIndex());
+}
+
+//Every strategy below works on indices; 0 means there is nothing left.
+int ParallelController::nextIndex() {
+	if(galloping) {
+		int probe = nextGallopStep();
+		if(probe != 0)
+			return probe;
 	}
 
-	chunks.erase(std::remove(chunks.begin(), chunks.end(), largestChunkPair), chunks.end());
+	if(workers > 0)
+		return nextKaryStep();
+
+	if(predict)
+		return nextCostStep();
+
+	if(widths.empty())
+		return 0;
+
+	auto chunk = chunks.find(-widths.rbegin()->second);
+	std::pair<int, int> largestChunkPair = *chunk;
+	removeChunk(chunk);
 
 	int median = largestChunkPair.first + floor((largestChunkPair.second - largestChunkPair.first) / 2.0);
 	if(median > 0) {
 		if(largestChunkPair.second - largestChunkPair.first > 1)
-			chunks.push_back(std::make_pair(largestChunkPair.first, median - 1));
+			addChunk(largestChunkPair.first, median - 1);
 
 		if(largestChunkPair.second != largestChunkPair.first)
-			chunks.push_back(std::make_pair(median + 1, largestChunkPair.second));
+			addChunk(median + 1, largestChunkPair.second);
 	}
 
 	return median;
 }
 
+int ParallelController::dispatch(int index) {
+	if(index != 0)
+		inFlight.insert(index);
+
+	return toStep(index);
+}
+
+//Each end gallops away from its bound: hmin, hmin+1, hmin+3, hmin+7, ... up,
+//hmax, hmax-1, hmax-3, ... down. The values skipped stay open for the workers
+//bisecting the interior. A result against the scan (a counterexample on the
+//way up, a proof on the way down) moves the bound it was heading for, so that
+//end starts over from its bound with a stride of 1. Past the last open value,
+//it does too.
+int ParallelController::takeLowest() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if(stopped || chunks.empty())
+		return 0;
+
+	int probe = 0;
+	if(lowLast != 0)
+		probe = takeOpen(lowLast + lowStride, true);
+
+	if(probe == 0) {
+		lowStride = 1;
+		probe = takeOpen(chunks.begin()->first, true);
+	}
+
+	if(probe == 0)
+		return 0;
+
+	lowLast = probe;
+	lowStride *= 2;
+	ends[probe] = false;
+
+	return dispatch(probe);
+}
+
+int ParallelController::takeHighest() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if(stopped || chunks.empty())
+		return 0;
+
+	int probe = 0;
+	if(highLast != 0)
+		probe = takeOpen(highLast - highStride, false);
+
+	if(probe == 0) {
+		highStride = 1;
+		probe = takeOpen(std::prev(chunks.end())->second, false);
+	}
+
+	if(probe == 0)
+		return 0;
+
+	highLast = probe;
+	highStride *= 2;
+	ends[probe] = true;
+
+	return dispatch(probe);
+}
+
+//The open value at index, or the nearest one past it in the direction of the
+//scan, taken out of its chunk; 0 when there is none. 0 means "nothing left",
+//so like the bisection this never hands out index 0.
+int ParallelController::takeOpen(int index, bool upwards) {
+	if(upwards)
+		index = std::max(index, 1);
+
+	//the first chunk starting above index.
+	auto chunk = chunks.upper_bound(index);
+
+	if(upwards) {
+		if(chunk != chunks.begin() && std::prev(chunk)->second >= index)
+			chunk = std::prev(chunk);
+		if(chunk == chunks.end())
+			return 0;
+		index = std::max(index, chunk->first);
+	} else {
+		if(chunk == chunks.begin())
+			return 0;
+		chunk = std::prev(chunk);
+		index = std::min(index, chunk->second);
+		if(index < 1)
+			return 0;
+	}
+
+	int first = chunk->first;
+	int second = chunk->second;
+	removeChunk(chunk);
+
+	addChunk(first, index - 1);
+	addChunk(index + 1, second);
+
+	return index;
+}
+
+int ParallelController::nextKaryStep() {
+	//probes left over from the last split, unless a result has ruled them out.
+	while(!probes.empty()) {
+		int probe = probes.front();
+		probes.pop_front();
+
+		if(probe >= hmin && probe <= hmax)
+			return probe;
+	}
+
+	if(widths.empty())
+		return 0;
+
+	int idle = workers;
+	for(int step : inFlight)
+		if(step >= hmin && step <= hmax)
+			idle--;
+	idle = std::max(1, idle);
+
+	auto chunk = chunks.find(-widths.rbegin()->second);
+	int first = chunk->first;
+	int second = chunk->second;
+	removeChunk(chunk);
+
+	//k probes at i * (n + 1) / (k + 1); with k == 1 this is plain bisection.
+	long long size = (long long) second - first + 2;
+	int previous = first - 1;
+
+	for(int i = 1; i <= idle; i++) {
+		int probe = first - 1 + (int) (size * i / (idle + 1));
+
+		if(probe <= previous || probe > second)
+			continue;
+
+		addChunk(previous + 1, probe - 1);
+		probes.push_back(probe);
+		previous = probe;
+	}
+
+	addChunk(previous + 1, second);
+
+	if(probes.empty())
+		return 0;
+
+	int probe = probes.front();
+	probes.pop_front();
+
+	return probe;
+}
+
+//Candidates are a few evenly spaced points in each of the widest chunks. With
+//the answer taken as uniform over the chunk [a, b] of size n, probing p removes
+//(b - p) on a false result and (p - a + 1) on a true one (only p itself when
+//the query is not monotone), each with its share of n.
+int ParallelController::nextCostStep() {
+	if(widths.empty())
+		return 0;
+
+	const int maxChunks = 16;
+	const int samples = 16;
+
+	std::map<int, int>::iterator best = chunks.end();
+	int bestStep = 0;
+	double bestScore = -1;
+	int visited = 0;
+
+	for(auto w = widths.rbegin(); w != widths.rend() && visited < maxChunks; ++w, visited++) {
+		auto chunk = chunks.find(-w->second);
+		int a = chunk->first;
+		int b = chunk->second;
+		double n = b - a + 1;
+
+		for(int i = 0; i <= samples; i++) {
+			int p = a + (int) ((b - a) * (long long) i / samples);
+			if(i > 0 && p == a)
+				continue;
+
+			double below = (p - a + 1) / n;
+			double reduction = below * (b - p) + (1 - below) * (monotone ? p - a + 1 : 1);
+			double score = (reduction + 1) / std::max(1e-3, predict(toStep(p)));
+
+			if(score > bestScore) {
+				bestScore = score;
+				bestStep = p;
+				best = chunk;
+			}
+
+			if(b == a)
+				break;
+		}
+	}
+
+	int first = best->first;
+	int second = best->second;
+	removeChunk(best);
+
+	addChunk(first, bestStep - 1);
+	addChunk(bestStep + 1, second);
+
+	return bestStep;
+}
+
+void ParallelController::setGallop(bool descending, int from) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	int low = hmin;
+	int high = hmax;
+
+	gallopDown = descending;
+	gallopBase = descending ? high : low;
+	if(from != 0)
+		gallopBase = std::min(high, std::max(low, toIndex(from)));
+
+	gallopOffset = 0;
+	gallopLast = descending ? gallopBase + 1 : gallopBase - 1;
+	galloping = high >= low;
+
+	//whatever lies behind the starting point is bisected once the gallop is over.
+	chunks.clear();
+	widths.clear();
+	if(descending)
+		addChunk(gallopBase + 1, high);
+	else
+		addChunk(low, gallopBase - 1);
+}
+
+//Each probe leaves the gap to the previous one as an ordinary chunk. Once a
+//result has moved the far bound inside the next probe, the answer is bracketed
+//and the probe is clamped to that bound, which ends the gallop.
+int ParallelController::nextGallopStep() {
+	int probe = gallopDown ? gallopBase - gallopOffset : gallopBase + gallopOffset;
+	gallopOffset = gallopOffset == 0 ? 1 : gallopOffset * 2;
+
+	int low = hmin;
+	int high = hmax;
+
+	if(probe < low || probe > high) {
+		probe = gallopDown ? std::max(low, probe) : std::min(high, probe);
+		galloping = false;
+	}
+
+	if(gallopDown ? probe >= gallopLast : probe <= gallopLast) {
+		galloping = false;
+		return 0;
+	}
+
+	if(gallopDown)
+		addChunk(probe + 1, gallopLast - 1);
+	else
+		addChunk(gallopLast + 1, probe - 1);
+
+	gallopLast = probe;
+
+	return probe;
+}
+
+void ParallelController::setCostModel(std::function<double(int)> predict) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	this->predict = predict;
+}
+
+void ParallelController::setKary(int workers) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	this->workers = std::max(0, workers);
+}
+
+void ParallelController::setNotifier(std::function<void()> notifier) {
+	this->notifier = notifier;
+}
+
+void ParallelController::setMonotone(bool monotone) {
+	this->monotone = monotone;
+}
+
+//Indices are 1-based so that 0 still means "no step left".
+void ParallelController::setDomain(std::vector<int> domain) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	this->domain = domain;
+	this->mapped = true;
+
+	hmin = 1;
+	hmax = domain.size();
+
+	chunks.clear();
+	widths.clear();
+	addChunk(hmin, hmax);
+}
+
+int ParallelController::toIndex(int step) {
+	if(!mapped)
+		return step;
+
+	//a value outside the domain maps to the next one above it.
+	return std::lower_bound(domain.begin(), domain.end(), step) - domain.begin() + 1;
+}
+
+int ParallelController::toStep(int index) {
+	if(!mapped || index == 0)
+		return index;
+
+	return domain[index - 1];
+}
+
 bool ParallelController::isStepNeeded(int threadNum) {
 	//std::cout << "isStepNeededRequested" << std::endl;
 
+	if(stopped)
+		return false;
+
+	threadNum = toIndex(threadNum);
+
 	return threadNum >= hmin && threadNum <= hmax;
 }
 
+//Lock-free like isStepNeeded, with the answer taken as uniform over the
+//bracket as in nextCostStep: steps far from its middle are the speculative ones.
+double ParallelController::getStepValue(int threadNum) {
+	if(!isStepNeeded(threadNum))
+		return 0;
+
+	int index = toIndex(threadNum);
+	int low = hmin;
+	int high = hmax;
+	double n = high - low + 1;
+	double below = (index - low + 1) / n;
+
+	return below * (high - index) + (1 - below) * (monotone ? index - low + 1 : 1);
+}
+
+void ParallelController::releaseStep(int threadNum) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto flight = inFlight.find(toIndex(threadNum));
+	if(flight != inFlight.end())
+		inFlight.erase(flight);
+}
+
+void ParallelController::setStepUnknown(int threadNum) {
+	releaseStep(threadNum);
+
+	if(isStepNeeded(threadNum)) {
+		std::lock_guard<std::mutex> lock(mutex);
+		unresolved.insert(toIndex(threadNum));
+	}
+}
+
+std::vector<int> ParallelController::getUnresolved() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::vector<int> steps;
+	for(auto it = unresolved.lower_bound(hmin); it != unresolved.end() && *it <= hmax; ++it)
+		steps.push_back(toStep(*it));
+
+	return steps;
+}
+
 void ParallelController::setStepResult(int threadNum, bool result) {
+	releaseStep(threadNum);
+
+	{
+		//another copy of the step may have ended UNKNOWN before this one.
+		std::lock_guard<std::mutex> lock(mutex);
+		unresolved.erase(toIndex(threadNum));
+
+		//a scan that met the result it was not expecting starts over from its bound.
+		auto end = ends.find(toIndex(threadNum));
+		if(end != ends.end()) {
+			if(end->second && result)
+				highLast = 0;
+			else if(!end->second && !result)
+				lowLast = 0;
+			ends.erase(end);
+		}
+	}
+
 	if(isStepNeeded(threadNum)) {
-		if(result == true && hmin < threadNum) {
-			hmin = threadNum;
-		} else if(hmax > threadNum) {
-			hmax = threadNum;
+		threadNum = toIndex(threadNum);
+
+		bool changed = false;
+
+		if(result == true) {
+			if(monotone)
+				changed = raiseMin(threadNum);
+		} else {
+			changed = lowerMax(threadNum);
+			feasible = true;
 		}
 
-		std::vector<std::pair<int, int>> toErase;
+		if(!changed)
+			return;
 
-		for(auto& c : chunks) {
-			if(c.first > hmax) {
-				toErase.push_back(c);
-			} else if(c.second < hmin) {
-				toErase.push_back(c);
-			} else {
-				c.first = std::max(hmin, c.first);
-				c.second = std::min(hmax, c.second);
-			}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			clipChunks();
+		}
+
+		if(notifier)
+			notifier();
+	}
+}
+
+void ParallelController::setSolution(int value) {
+	value = toIndex(value);
+
+	if(value >= hmin && lowerMax(value)) {
+		feasible = true;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			clipChunks();
 		}
 
-		for(auto &c : toErase) {
-			chunks.erase(std::remove(chunks.begin(), chunks.end(), c), chunks.end());
+		if(notifier)
+			notifier();
+	}
+}
+
+//lower: the smallest value not yet ruled out, i.e. the lowest open, queued or
+//in-flight step; upper: hmax, which is only a proven solution once something failed.
+bool ParallelController::getBounds(int& lower, int& upper) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	lower = toStep(stopped ? stoppedLower : lowestOpen());
+	upper = toStep(hmax);
+
+	return feasible;
+}
+
+int ParallelController::lowestOpen() {
+	int low = hmin;
+	int high = hmax;
+	int open = high;
+
+	if(!chunks.empty())
+		open = std::min(open, chunks.begin()->first);
+
+	for(int step : inFlight) {
+		if(step >= low && step <= high) {
+			open = std::min(open, step);
+			break;
 		}
 	}
+
+	for(int probe : probes)
+		if(probe >= low)
+			open = std::min(open, probe);
+
+	auto unknown = unresolved.lower_bound(low);
+	if(unknown != unresolved.end())
+		open = std::min(open, *unknown);
+
+	//values the gallop has not reached yet are in no chunk.
+	if(galloping)
+		open = std::min(open, gallopDown ? low : gallopLast + 1);
+
+	return std::max(open, low);
+}
+
+//the bounds are frozen as they were when the search was stopped.
+bool ParallelController::stop() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if(stopped)
+		return false;
+
+	stoppedLower = lowestOpen();
+	stopped = true;
+	chunks.clear();
+	widths.clear();
+	probes.clear();
+	galloping = false;
+
+	return true;
+}
+
+bool ParallelController::raiseMin(int value) {
+	int current = hmin;
+
+	while(current < value) {
+		if(hmin.compare_exchange_weak(current, value))
+			return true;
+	}
+
+	return false;
+}
+
+bool ParallelController::lowerMax(int value) {
+	int current = hmax;
+
+	while(current > value) {
+		if(hmax.compare_exchange_weak(current, value))
+			return true;
+	}
+
+	return false;
+}
+
+void ParallelController::addChunk(int first, int second) {
+	if(second < first)
+		return;
+
+	chunks[first] = second;
+	widths.insert(std::make_pair(second - first, -first));
+}
+
+void ParallelController::removeChunk(std::map<int, int>::iterator chunk) {
+	widths.erase(std::make_pair(chunk->second - chunk->first, -chunk->first));
+	chunks.erase(chunk);
+}
+
+//Only the chunks that cross a bound are touched, so this is O(k log n).
+void ParallelController::clipChunks() {
+	int low = hmin;
+	int high = hmax;
+
+	while(!chunks.empty() && chunks.rbegin()->first > high)
+		removeChunk(std::prev(chunks.end()));
+
+	if(!chunks.empty() && chunks.rbegin()->second > high) {
+		int first = chunks.rbegin()->first;
+		removeChunk(std::prev(chunks.end()));
+		addChunk(first, high);
+	}
+
+	while(!chunks.empty() && chunks.begin()->second < low)
+		removeChunk(chunks.begin());
+
+	if(!chunks.empty() && chunks.begin()->first < low) {
+		int second = chunks.begin()->second;
+		removeChunk(chunks.begin());
+		addChunk(low, second);
+	}
 }
@@ -8,21 +8,106 @@
 #ifndef PARALLELCONTROLLER_H_
 #define PARALLELCONTROLLER_H_
 
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
 #include <vector>
 
 
+//Safe to share between workers without any outside locking: the bounds are
+//atomics, so isStepNeeded() never blocks, and the open chunks live in two
+//ordered sets (by position and by width) behind one mutex.
 class ParallelController {
 public:
 	ParallelController(int hmin, int hmax);
 	virtual ~ParallelController();
 
 	int getNextStep();
+	//bidirectional scans: the next value of a gallop up from the lower bound or
+	//down from the upper one. Other workers bisect with getNextStep meanwhile.
+	int takeLowest();
+	int takeHighest();
 	void setStepResult(int threadNum, bool result);
+	//a dispatched step that ended without a result, e.g. it was aborted.
+	void releaseStep(int threadNum);
+	//a step that ended UNKNOWN or ERROR: it rules nothing out and, while its
+	//bracket is still open, keeps the lower bound from passing it.
+	void setStepUnknown(int threadNum);
+	//the unknown steps still inside the bracket.
+	std::vector<int> getUnresolved();
+	//a proven feasible objective value, e.g. recomputed from a counterexample.
+	void setSolution(int value);
 	bool isStepNeeded(int threadNum);
+	//the expected number of values the step's result removes from the bracket.
+	double getStepValue(int threadNum);
+
+	void setNotifier(std::function<void()> notifier);
+	//false for exact-value queries: a true result then only rules out its own step.
+	void setMonotone(bool monotone);
+	//only these sorted values are handed out; bisection runs over their indices.
+	void setDomain(std::vector<int> domain);
+	//k-ary mode: each round splits the widest open chunk into k+1 equal parts,
+	//k being the number of workers not busy on a step that is still needed.
+	void setKary(int workers);
+	//picks the step with the best expected interval reduction per predicted second.
+	void setCostModel(std::function<double(int)> predict);
+	//probes from, from+1, from+2, from+4, ... (downwards when descending) until
+	//the answer is bracketed, then bisects the gaps. 0 starts at the chosen end.
+	void setGallop(bool descending, int from);
+
+	//true once upper is a proven solution; lower is proven either way.
+	bool getBounds(int& lower, int& upper);
+	//hands out nothing more and reports every step as not needed.
+	bool stop();
 private:
-	int hmin;
-	int hmax;
-	std::vector<std::pair<int, int>> chunks;
+	int lowestOpen();
+	int nextIndex();
+	int dispatch(int index);
+	int takeOpen(int index, bool upwards);
+	int nextGallopStep();
+	int nextKaryStep();
+	int nextCostStep();
+	void addChunk(int first, int second);
+	void removeChunk(std::map<int, int>::iterator chunk);
+	void clipChunks();
+	bool raiseMin(int value);
+	bool lowerMax(int value);
+	int toIndex(int step);
+	int toStep(int index);
+
+	std::atomic<int> hmin;
+	std::atomic<int> hmax;
+	bool monotone;
+	bool mapped;
+	std::vector<int> domain;
+	std::mutex mutex;
+	//first -> second, and (width, -first) so the widest, lowest chunk is last.
+	std::map<int, int> chunks;
+	std::set<std::pair<int, int>> widths;
+	int workers;
+	std::atomic<bool> stopped;
+	std::atomic<bool> feasible;
+	int stoppedLower;
+	bool galloping;
+	bool gallopDown;
+	int gallopBase;
+	int gallopOffset;
+	int gallopLast;
+	std::deque<int> probes;
+	std::multiset<int> inFlight;
+	std::set<int> unresolved;
+	//values handed out by takeLowest (false) or takeHighest (true), until they have a result.
+	std::map<int, bool> ends;
+	//the last value each end scan handed out (0: start at the bound) and its next stride.
+	int lowLast;
+	int lowStride;
+	int highLast;
+	int highStride;
+	std::function<void()> notifier;
+	std::function<double(int)> predict;
 };
 
 #endif /* PARALLELCONTROLLER_H_ */
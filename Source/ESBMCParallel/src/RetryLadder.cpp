@@ -0,0 +1,96 @@
+/*
+ * RetryLadder.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "RetryLadder.h"
+
+#include <cstdlib>
+#include <sstream>
+
+RetryLadder::RetryLadder() {
+	this->softTimeout = 0;
+	this->hardTimeout = 0;
+}
+
+RetryLadder::~RetryLadder() {
+
+}
+
+bool RetryLadder::isSolver(std::string name) {
+	return name == "boolector" || name == "z3" || name == "yices" || name == "cvc" || name == "mathsat"
+			|| name == "bitwuzla";
+}
+
+void RetryLadder::setTimeouts(double soft, double hard) {
+	this->softTimeout = soft;
+	this->hardTimeout = hard;
+}
+
+//xF scales the timeouts by F, a solver name switches solver, jobs=N allows at
+//most N children (this one included) while the step runs.
+bool RetryLadder::parse(std::string spec) {
+	std::istringstream stream(spec);
+	std::string rung;
+
+	rungs.clear();
+
+	while (std::getline(stream, rung, ',')) {
+		if (rung.find("--") == 0)
+			rung = rung.substr(2);
+
+		if (rung.size() > 1 && rung[0] == 'x' && std::atof(rung.c_str() + 1) >= 1)
+			rungs.push_back(rung);
+		else if (rung.find("jobs=") == 0 && std::atoi(rung.c_str() + 5) >= 1)
+			rungs.push_back(rung);
+		else if (isSolver(rung))
+			rungs.push_back(rung);
+		else
+			return false;
+	}
+
+	return !rungs.empty();
+}
+
+int RetryLadder::getAttempts() {
+	return rungs.size() + 1;
+}
+
+Attempt RetryLadder::getAttempt(int attempt) {
+	Attempt result { StepLimits { softTimeout, hardTimeout, 0, 0, 0, 0 }, "" };
+
+	for (int i = 0; i < attempt && i < (int) rungs.size(); i++) {
+		std::string rung = rungs[i];
+
+		if (rung[0] == 'x') {
+			double factor = std::atof(rung.c_str() + 1);
+			result.limits.softTimeout *= factor;
+			result.limits.hardTimeout *= factor;
+		} else if (rung.find("jobs=") == 0) {
+			result.limits.maxRunning = std::atoi(rung.c_str() + 5);
+		} else {
+			result.solver = "--" + rung;
+		}
+	}
+
+	return result;
+}
+
+std::string RetryLadder::describe(int attempt) {
+	Attempt current = getAttempt(attempt);
+	std::ostringstream text;
+
+	if (current.limits.softTimeout > 0)
+		text << "timeout " << current.limits.softTimeout << "s";
+	else
+		text << "no timeout";
+
+	if (!current.solver.empty())
+		text << ", " << current.solver;
+
+	if (current.limits.maxRunning > 0)
+		text << ", " << current.limits.maxRunning << (current.limits.maxRunning == 1 ? " job" : " jobs");
+
+	return text.str();
+}
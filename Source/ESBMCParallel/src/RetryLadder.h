@@ -0,0 +1,46 @@
+/*
+ * RetryLadder.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef RETRYLADDER_H_
+#define RETRYLADDER_H_
+
+#include <string>
+#include <vector>
+
+#include "ChildSupervisor.h"
+
+//The limits and solver of one attempt at a step; an empty solver keeps the default.
+struct Attempt {
+	StepLimits limits;
+	std::string solver;
+};
+
+//What to try, in order, after a step ends UNKNOWN or ERROR. Each rung builds
+//on the one before: "x2,z3,jobs=1" first doubles the timeouts, then also
+//switches to z3, then also runs the step with no other child alongside.
+class RetryLadder {
+public:
+	RetryLadder();
+	virtual ~RetryLadder();
+
+	//seconds; 0 is no timeout.
+	void setTimeouts(double soft, double hard);
+	bool parse(std::string spec);
+
+	//the first attempt plus one per rung.
+	int getAttempts();
+	Attempt getAttempt(int attempt);
+	std::string describe(int attempt);
+
+	//a solver name as written in a rung, without the leading "--".
+	static bool isSolver(std::string name);
+private:
+	double softTimeout;
+	double hardTimeout;
+	std::vector<std::string> rungs;
+};
+
+#endif /* RETRYLADDER_H_ */
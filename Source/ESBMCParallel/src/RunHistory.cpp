@@ -0,0 +1,98 @@
+/*
+ * RunHistory.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "RunHistory.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+
+RunHistory::RunHistory() {
+	this->opened = false;
+}
+
+RunHistory::~RunHistory() {
+
+}
+
+//Line format: key allocation jobs seconds
+bool RunHistory::open(std::string path, std::string key) {
+	this->path = path;
+	this->key = key;
+	this->opened = true;
+
+	std::ifstream file(path);
+	std::string line;
+
+	while (std::getline(file, line)) {
+		std::istringstream fields(line);
+		std::string lineKey, allocation;
+		int jobs;
+		double seconds;
+
+		if (!(fields >> lineKey >> allocation >> jobs >> seconds) || lineKey != key)
+			continue;
+
+		Entry& entry = entries[split(allocation, jobs)];
+		entry.runs++;
+		entry.seconds += seconds;
+	}
+
+	return true;
+}
+
+bool RunHistory::isOpen() {
+	return opened;
+}
+
+void RunHistory::record(std::string allocation, int jobs, double seconds) {
+	if (!opened)
+		return;
+
+	std::ofstream file(path, std::ios::app);
+	if (!file) {
+		perror(path.c_str());
+		return;
+	}
+
+	file << key << " " << allocation << " " << jobs << " " << seconds << std::endl;
+
+	Entry& entry = entries[split(allocation, jobs)];
+	entry.runs++;
+	entry.seconds += seconds;
+}
+
+std::string RunHistory::best(std::vector<std::string> candidates, int jobs) {
+	std::string choice;
+	double fastest = 0;
+
+	for (auto &candidate : candidates) {
+		if (getRuns(candidate, jobs) == 0)
+			return candidate;
+
+		double mean = getMean(candidate, jobs);
+		if (choice.empty() || mean < fastest) {
+			choice = candidate;
+			fastest = mean;
+		}
+	}
+
+	return choice;
+}
+
+int RunHistory::getRuns(std::string allocation, int jobs) {
+	auto it = entries.find(split(allocation, jobs));
+	return it == entries.end() ? 0 : it->second.runs;
+}
+
+double RunHistory::getMean(std::string allocation, int jobs) {
+	auto it = entries.find(split(allocation, jobs));
+	return it == entries.end() || it->second.runs == 0 ? 0 : it->second.seconds / it->second.runs;
+}
+
+std::string RunHistory::split(std::string allocation, int jobs) {
+	return allocation + "/" + std::to_string(jobs);
+}
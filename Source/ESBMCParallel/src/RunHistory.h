@@ -0,0 +1,43 @@
+/*
+ * RunHistory.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef RUNHISTORY_H_
+#define RUNHISTORY_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+//End-to-end times of earlier runs, one line per run, keyed like the step
+//cache. Used to choose how spare cores are split between in-flight steps.
+class RunHistory {
+public:
+	RunHistory();
+	virtual ~RunHistory();
+
+	bool open(std::string path, std::string key);
+	bool isOpen();
+
+	void record(std::string allocation, int jobs, double seconds);
+	//an untried candidate first, then the one with the lowest mean time.
+	std::string best(std::vector<std::string> candidates, int jobs);
+	int getRuns(std::string allocation, int jobs);
+	double getMean(std::string allocation, int jobs);
+private:
+	struct Entry {
+		int runs;
+		double seconds;
+	};
+
+	std::string path;
+	std::string key;
+	bool opened;
+	std::map<std::string, Entry> entries;
+
+	static std::string split(std::string allocation, int jobs);
+};
+
+#endif /* RUNHISTORY_H_ */
@@ -0,0 +1,79 @@
+/*
+ * RuntimeModel.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "RuntimeModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+//below this, timer noise dominates and log() would blow up.
+#define MIN_SECONDS 0.01
+
+RuntimeModel::RuntimeModel() {
+	this->bandwidth = 1.0;
+}
+
+RuntimeModel::~RuntimeModel() {
+
+}
+
+//the kernel spans a twentieth of the searched range.
+void RuntimeModel::setRange(int hmin, int hmax) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	this->bandwidth = std::max(1.0, (hmax - hmin) / 20.0);
+}
+
+void RuntimeModel::observe(int step, double seconds) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	steps.push_back(step);
+	logSeconds.push_back(log(std::max(MIN_SECONDS, seconds)));
+}
+
+//With no samples every step costs the same, which leaves the choice to the
+//interval reduction alone.
+double RuntimeModel::predict(int step) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (steps.empty())
+		return 1.0;
+
+	double weights = 0;
+	double sum = 0;
+	double mean = 0;
+
+	for (size_t i = 0; i < steps.size(); i++) {
+		double distance = (step - steps[i]) / bandwidth;
+		double weight = exp(-0.5 * distance * distance);
+
+		weights += weight;
+		sum += weight * logSeconds[i];
+		mean += logSeconds[i];
+	}
+
+	mean /= steps.size();
+
+	//far from every sample the kernel weights vanish: fall back to the mean.
+	double prior = 1e-3;
+
+	return exp((sum + prior * mean) / (weights + prior));
+}
+
+double RuntimeModel::getMaximum() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	double maximum = 0;
+	for (double value : logSeconds)
+		maximum = std::max(maximum, exp(value));
+
+	return maximum;
+}
+
+int RuntimeModel::getSamples() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return steps.size();
+}
@@ -0,0 +1,35 @@
+/*
+ * RuntimeModel.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef RUNTIMEMODEL_H_
+#define RUNTIMEMODEL_H_
+
+#include <mutex>
+#include <vector>
+
+//Online estimate of ESBMC wall time as a function of the bound: a Gaussian
+//kernel average of log(seconds) over the steps seen so far, so the slow band
+//around the optimum shows up after a handful of samples.
+class RuntimeModel {
+public:
+	RuntimeModel();
+	virtual ~RuntimeModel();
+
+	void setRange(int hmin, int hmax);
+
+	void observe(int step, double seconds);
+	double predict(int step);
+	//the largest value observed so far.
+	double getMaximum();
+	int getSamples();
+private:
+	double bandwidth;
+	std::vector<int> steps;
+	std::vector<double> logSeconds;
+	std::mutex mutex;
+};
+
+#endif /* RUNTIMEMODEL_H_ */
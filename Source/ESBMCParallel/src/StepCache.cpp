@@ -0,0 +1,177 @@
+/*
+ * StepCache.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "StepCache.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdint.h>
+#include <stdio.h>
+
+//"0110?..." for a witness, "-" when there is none.
+static std::string encode_witness(std::vector<int>& witness) {
+	std::string text;
+	bool known = false;
+
+	for (int value : witness) {
+		text += value < 0 ? '?' : (char) ('0' + value);
+		known = known || value >= 0;
+	}
+
+	return known ? text : "-";
+}
+
+static std::vector<int> decode_witness(std::string& text) {
+	std::vector<int> witness;
+
+	if (text == "-")
+		return witness;
+
+	for (char c : text)
+		witness.push_back(c == '?' ? -1 : c - '0');
+
+	return witness;
+}
+
+StepCache::StepCache() {
+	this->opened = false;
+	this->lookups = true;
+	this->hits = 0;
+	this->stored = 0;
+}
+
+StepCache::~StepCache() {
+
+}
+
+//Line format: key step verdict wall_seconds max_rss_kb witness
+bool StepCache::open(std::string path, std::string key) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	this->path = path;
+	this->key = key;
+	this->opened = true;
+
+	std::ifstream file(path);
+	std::string line;
+
+	while (std::getline(file, line)) {
+		std::istringstream fields(line);
+		std::string lineKey, verdict, witness;
+		ChildResult result { 0, VERDICT_NONE, "", std::vector<int>(), 0, false, 0, 0, 0, true, false, false };
+
+		if (!(fields >> lineKey >> result.step >> verdict >> result.wallSeconds >> result.maxRssKb >> witness))
+			continue;
+
+		if (lineKey != key)
+			continue;
+
+		if (verdict == "FAILED")
+			result.verdict = VERDICT_FAILED;
+		else if (verdict == "SUCCESSFUL")
+			result.verdict = VERDICT_SUCCESSFUL;
+		else
+			continue;
+
+		result.witness = decode_witness(witness);
+		entries[result.step] = result;
+	}
+
+	return true;
+}
+
+void StepCache::setLookups(bool enabled) {
+	std::lock_guard<std::mutex> lock(mutex);
+	this->lookups = enabled;
+}
+
+bool StepCache::isOpen() {
+	return opened;
+}
+
+bool StepCache::lookup(int step, ChildResult& result) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto it = entries.find(step);
+	if (!lookups || it == entries.end())
+		return false;
+
+	result = it->second;
+	hits++;
+
+	return true;
+}
+
+//Only a definitive verdict is worth keeping: aborted, timed out or broken runs are not.
+void StepCache::store(ChildResult& result) {
+	if (result.aborted || result.cached || (result.verdict != VERDICT_FAILED && result.verdict != VERDICT_SUCCESSFUL))
+		return;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (!opened || entries.count(result.step) > 0)
+		return;
+
+	std::ofstream file(path, std::ios::app);
+	if (!file) {
+		perror(path.c_str());
+		return;
+	}
+
+	file << key << " " << result.step << " " << (result.verdict == VERDICT_FAILED ? "FAILED" : "SUCCESSFUL") << " "
+			<< result.wallSeconds << " " << result.maxRssKb << " " << encode_witness(result.witness) << std::endl;
+
+	ChildResult entry = result;
+	entry.output.clear();
+	entry.cached = true;
+	entries[result.step] = entry;
+	stored++;
+}
+
+std::vector<int> StepCache::getSteps() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::vector<int> steps;
+	for (auto &e : entries)
+		steps.push_back(e.first);
+
+	return steps;
+}
+
+std::vector<ChildResult> StepCache::getResults() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::vector<ChildResult> results;
+	for (auto &e : entries)
+		results.push_back(e.second);
+
+	return results;
+}
+
+int StepCache::getHits() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return hits;
+}
+
+int StepCache::getStored() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return stored;
+}
+
+//64-bit FNV-1a, printed as 16 hex digits.
+std::string StepCache::hash(std::string text) {
+	uint64_t value = 14695981039346656037ULL;
+
+	for (unsigned char c : text) {
+		value ^= c;
+		value *= 1099511628211ULL;
+	}
+
+	char buffer[17];
+	snprintf(buffer, sizeof(buffer), "%016llx", (unsigned long long) value);
+
+	return buffer;
+}
@@ -0,0 +1,50 @@
+/*
+ * StepCache.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef STEPCACHE_H_
+#define STEPCACHE_H_
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ChildSupervisor.h"
+
+//Persistent step results, one line per step, appended as steps finish.
+//Entries are keyed by a hash of everything that can change a verdict: the
+//model source, the ESBMC version, the solver flags and the extra macros.
+class StepCache {
+public:
+	StepCache();
+	virtual ~StepCache();
+
+	bool open(std::string path, std::string key);
+	bool isOpen();
+
+	bool lookup(int step, ChildResult& result);
+	//false: lookups miss, as on a cold run, while new results are still stored.
+	void setLookups(bool enabled);
+	void store(ChildResult& result);
+	std::vector<int> getSteps();
+	std::vector<ChildResult> getResults();
+
+	int getHits();
+	int getStored();
+
+	static std::string hash(std::string text);
+private:
+	std::string path;
+	std::string key;
+	bool opened;
+	bool lookups;
+	int hits;
+	int stored;
+	std::map<int, ChildResult> entries;
+	std::mutex mutex;
+};
+
+#endif /* STEPCACHE_H_ */
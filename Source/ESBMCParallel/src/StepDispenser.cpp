@@ -0,0 +1,50 @@
+/*
+ * StepDispenser.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "StepDispenser.h"
+
+StepDispenser::StepDispenser(int count, bool descending) {
+	this->count = count;
+	this->descending = descending;
+	this->cursor = descending ? count - 1 : 0;
+	this->bound = descending ? -1 : count;
+}
+
+StepDispenser::~StepDispenser() {
+
+}
+
+int StepDispenser::next() {
+	int index = descending ? cursor.fetch_sub(1) : cursor.fetch_add(1);
+
+	if (index < 0 || index >= count || !isNeeded(index))
+		return -1;
+
+	return index;
+}
+
+bool StepDispenser::isNeeded(int index) {
+	return descending ? index > bound : index < bound;
+}
+
+bool StepDispenser::confirm(int index) {
+	int current = bound;
+
+	while (descending ? index > current : index < current) {
+		if (bound.compare_exchange_weak(current, index))
+			return true;
+	}
+
+	return false;
+}
+
+bool StepDispenser::hasBound() {
+	return descending ? bound >= 0 : bound < count;
+}
+
+int StepDispenser::getBound() {
+	return bound;
+}
@@ -0,0 +1,36 @@
+/*
+ * StepDispenser.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef STEPDISPENSER_H_
+#define STEPDISPENSER_H_
+
+#include <atomic>
+
+//Hands out step indices 0..count-1 in ascending or descending order to any
+//number of workers without locks. Once a qualifying index is confirmed, every
+//index past it (above it in ascending order, below it in descending order)
+//is no longer handed out and reports itself as not needed.
+class StepDispenser {
+public:
+	StepDispenser(int count, bool descending);
+	virtual ~StepDispenser();
+
+	//-1 once the steps are exhausted or cut off by the bound.
+	int next();
+	bool isNeeded(int index);
+	//true when this index moved the bound.
+	bool confirm(int index);
+
+	bool hasBound();
+	int getBound();
+private:
+	int count;
+	bool descending;
+	std::atomic<int> cursor;
+	std::atomic<int> bound;
+};
+
+#endif /* STEPDISPENSER_H_ */
@@ -0,0 +1,170 @@
+/*
+ * VerdictScanner.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "VerdictScanner.h"
+
+#include <cstdlib>
+#include <ctype.h>
+#include <string.h>
+
+#define MAX_LINE 16384
+
+static void trim(std::string& text) {
+	size_t first = text.find_first_not_of(" \t\r");
+	size_t last = text.find_last_not_of(" \t\r");
+
+	if (first == std::string::npos)
+		text.clear();
+	else
+		text = text.substr(first, last - first + 1);
+}
+
+//TRUE/FALSE, true/false or a number, optionally followed by "(00000001)".
+static int parse_value(const char* text) {
+	while (isspace(*text))
+		text++;
+
+	if (strncasecmp(text, "true", 4) == 0)
+		return 1;
+	if (strncasecmp(text, "false", 5) == 0)
+		return 0;
+	if (isdigit(*text) || *text == '-')
+		return std::atoi(text) != 0 ? 1 : 0;
+
+	return -1;
+}
+
+VerdictScanner::VerdictScanner(size_t capacity, bool traceOnly) {
+	this->verdict = VERDICT_NONE;
+	this->traceOnly = traceOnly;
+	this->inTrace = false;
+	this->ring.resize(capacity > 0 ? capacity : 1);
+	this->head = 0;
+	this->size = 0;
+}
+
+VerdictScanner::~VerdictScanner() {
+
+}
+
+void VerdictScanner::feed(const char* data, size_t length) {
+	for (size_t i = 0; i < length; i++) {
+		char c = data[i];
+
+		if (!traceOnly || inTrace)
+			store(c);
+
+		if (c == '\n') {
+			scanLine();
+			line.clear();
+		} else if (line.size() < MAX_LINE) {
+			line += c;
+		}
+	}
+}
+
+void VerdictScanner::finish() {
+	if (!line.empty()) {
+		scanLine();
+		line.clear();
+	}
+}
+
+void VerdictScanner::watch(std::string variable, int size) {
+	this->variable = variable;
+	this->witness.assign(size, -1);
+}
+
+Verdict VerdictScanner::getVerdict() {
+	return verdict;
+}
+
+std::string VerdictScanner::getOutput() {
+	std::string output;
+	output.reserve(size);
+
+	size_t first = (head + ring.size() - size) % ring.size();
+	for (size_t i = 0; i < size; i++)
+		output += ring[(first + i) % ring.size()];
+
+	return output;
+}
+
+std::vector<int> VerdictScanner::getWitness() {
+	return witness;
+}
+
+void VerdictScanner::scanLine() {
+	if (line.compare(0, 19, "VERIFICATION FAILED") == 0) {
+		verdict = VERDICT_FAILED;
+		inTrace = false;
+	} else if (line.compare(0, 23, "VERIFICATION SUCCESSFUL") == 0) {
+		verdict = VERDICT_SUCCESSFUL;
+	} else if (line.compare(0, 20, "VERIFICATION UNKNOWN") == 0) {
+		verdict = VERDICT_UNKNOWN;
+	} else if (line.compare(0, 15, "Counterexample:") == 0) {
+		inTrace = true;
+	} else if (inTrace && !witness.empty()) {
+		scanAssignment();
+	}
+}
+
+//Accepts both "faux::x[3]=1 (00000001)" and "x={ TRUE, FALSE, ... }".
+void VerdictScanner::scanAssignment() {
+	size_t equals = line.find('=');
+	if (equals == std::string::npos || equals == 0)
+		return;
+
+	std::string name = line.substr(0, equals);
+	trim(name);
+
+	int index = -1;
+	if (!name.empty() && name[name.size() - 1] == ']') {
+		size_t open = name.rfind('[');
+		if (open == std::string::npos)
+			return;
+
+		index = std::atoi(name.c_str() + open + 1);
+		name = name.substr(0, open);
+		trim(name);
+	}
+
+	size_t scope = name.rfind("::");
+	if (scope != std::string::npos)
+		name = name.substr(scope + 2);
+
+	if (name != variable)
+		return;
+
+	const char* value = line.c_str() + equals + 1;
+
+	if (index >= 0) {
+		if (index < (int) witness.size())
+			witness[index] = parse_value(value);
+		return;
+	}
+
+	const char* open = strchr(value, '{');
+	if (open == NULL)
+		return;
+
+	const char* item = open + 1;
+	for (size_t i = 0; i < witness.size() && item != NULL; i++) {
+		witness[i] = parse_value(item);
+
+		item = strchr(item, ',');
+		if (item != NULL)
+			item++;
+	}
+}
+
+void VerdictScanner::store(char c) {
+	ring[head] = c;
+	head = (head + 1) % ring.size();
+
+	if (size < ring.size())
+		size++;
+}
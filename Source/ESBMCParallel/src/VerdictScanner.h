@@ -0,0 +1,50 @@
+/*
+ * VerdictScanner.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef VERDICTSCANNER_H_
+#define VERDICTSCANNER_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+//UNKNOWN: ESBMC gave up or hit a timeout; ERROR: it crashed, was killed or
+//printed no verdict. Neither says anything about the step.
+enum Verdict { VERDICT_NONE, VERDICT_FAILED, VERDICT_SUCCESSFUL, VERDICT_UNKNOWN, VERDICT_ERROR };
+
+//Classifies ESBMC output while it streams in. Only a fixed-size ring buffer of
+//the output (or of the counterexample section alone) is kept, plus the last
+//values the counterexample assigned to one watched array.
+class VerdictScanner {
+public:
+	VerdictScanner(size_t capacity, bool traceOnly);
+	virtual ~VerdictScanner();
+
+	void feed(const char* data, size_t length);
+	void finish();
+
+	void watch(std::string variable, int size);
+
+	Verdict getVerdict();
+	std::string getOutput();
+	std::vector<int> getWitness();
+private:
+	void scanLine();
+	void scanAssignment();
+	void store(char c);
+
+	Verdict verdict;
+	bool traceOnly;
+	bool inTrace;
+	std::string line;
+	std::vector<char> ring;
+	size_t head;
+	size_t size;
+	std::string variable;
+	std::vector<int> witness;
+};
+
+#endif /* VERDICTSCANNER_H_ */